@@ -0,0 +1,104 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "AllocCounter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+std::atomic<std::uint64_t> AllocCounterValue{0U};
+
+inline void countAlloc()
+{
+    AllocCounterValue.fetch_add(1U, std::memory_order_relaxed);
+}
+
+} // namespace 
+
+std::uint64_t allocCount()
+{
+    return AllocCounterValue.load(std::memory_order_relaxed);
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+#ifdef __GLIBC__
+
+extern "C" 
+{
+
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t count, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+
+void* malloc(std::size_t size) noexcept
+{
+    cc_plugin_mqtt5_client_filter::bench::countAlloc();
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t count, std::size_t size) noexcept
+{
+    cc_plugin_mqtt5_client_filter::bench::countAlloc();
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, std::size_t size) noexcept
+{
+    cc_plugin_mqtt5_client_filter::bench::countAlloc();
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+#else // #ifdef __GLIBC__
+
+void* operator new(std::size_t size)
+{
+    cc_plugin_mqtt5_client_filter::bench::countAlloc();
+    auto* ptr = std::malloc((size == 0U) ? 1U : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+    std::free(ptr);
+}
+
+#endif // #ifdef __GLIBC__
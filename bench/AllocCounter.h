@@ -0,0 +1,36 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+// Number of the heap allocations performed by the process so far. With glibc
+// the malloc family is interposed, which also covers the allocations made
+// by Qt directly, elsewhere only the C++ operator new is counted.
+std::uint64_t allocCount();
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,167 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "ClientSession.h"
+
+#include <cc_tools_qt/ToolsDataInfo.h>
+
+#include <memory>
+#include <utility>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+ClientSession::ClientSession(const FakeBroker::Config& brokerConfig, const ConfigFunc& configFunc) :
+    m_broker(brokerConfig),
+    m_filter(makeMqtt5ClientFilter())
+{
+    // The virtual time is driven from this thread, the engine must
+    // not be moved to the worker thread.
+    auto timeSource = std::make_unique<Mqtt5ClientFilterVirtualTimeSource>();
+    m_time = timeSource.get();
+    m_startTs = m_time->now();
+    m_filter->setTimeSource(std::move(timeSource));
+
+    m_filter->updateConfig(
+        [&configFunc](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_clientId = "check";
+            configFunc(config);
+            config.m_workerThread = false;
+        });
+
+    QObject::connect(
+        m_filter.get(), &cc_tools_qt::ToolsFilter::sigDataToSendReport,
+        [this](cc_tools_qt::ToolsDataInfoPtr dataPtr)
+        {
+            sendToBroker(dataPtr->m_data);
+        });
+
+    QObject::connect(
+        m_filter.get(), &cc_tools_qt::ToolsFilter::sigErrorReport,
+        [this](const QString& msg)
+        {
+            m_errors.append(msg);
+        });
+}
+
+ClientSession::~ClientSession()
+{
+    disconnect();
+}
+
+void ClientSession::connect()
+{
+    m_filter->start();
+    m_filter->socketConnectionReport(true);
+    m_connected = true;
+    deliverBrokerOutput();
+}
+
+void ClientSession::disconnect()
+{
+    if (!m_connected) {
+        return;
+    }
+
+    m_filter->stop();
+    m_filter->socketConnectionReport(false);
+    m_connected = false;
+}
+
+void ClientSession::dropConnection()
+{
+    m_filter->socketConnectionReport(false);
+}
+
+void ClientSession::restoreConnection()
+{
+    m_filter->socketConnectionReport(true);
+    deliverBrokerOutput();
+}
+
+void ClientSession::publish(const DataSeq& payload, const QVariantMap& props)
+{
+    auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+    dataPtr->m_data = payload;
+    dataPtr->m_extraProperties = props;
+    auto sent = m_filter->sendData(std::move(dataPtr));
+    for (auto& sentPtr : sent) {
+        sendToBroker(sentPtr->m_data);
+    }
+
+    deliverBrokerOutput();
+}
+
+void ClientSession::receive(const DataSeq& data)
+{
+    auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+    dataPtr->m_data = data;
+    m_received.append(m_filter->recvData(std::move(dataPtr)));
+}
+
+void ClientSession::advance(std::chrono::milliseconds duration)
+{
+    while (true) {
+        auto remaining = m_time->timeoutRemaining();
+        if ((remaining.count() < 0) || (duration < remaining)) {
+            break;
+        }
+
+        duration -= remaining;
+        m_time->advanceToTimeout();
+        deliverBrokerOutput();
+    }
+
+    m_time->advance(duration);
+}
+
+void ClientSession::deliverBrokerOutput()
+{
+    while (m_broker.hasOutput()) {
+        receive(m_broker.takeOutput());
+    }
+}
+
+std::chrono::milliseconds ClientSession::elapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(m_time->now() - m_startTs);
+}
+
+void ClientSession::sendToBroker(const DataSeq& data)
+{
+    auto pings = m_broker.pingsReceived();
+    m_broker.processClientData(data);
+    if (pings < m_broker.pingsReceived()) {
+        m_pingTimes.push_back(elapsed());
+    }
+}
+
+ClientSession::DataInfosList ClientSession::takeReceived()
+{
+    DataInfosList result;
+    result.swap(m_received);
+    return result;
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,121 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include "FakeBroker.h"
+#include "Verify.h"
+
+#include "Mqtt5ClientFilter.h"
+#include "Mqtt5ClientFilterVirtualTimeSource.h"
+
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+// The filter connected to the broker stand-in and driven by the virtual
+// time, used by the functional checks.
+class ClientSession
+{
+public:
+    using DataSeq = FakeBroker::DataSeq;
+    using ConfigFunc = std::function<void (Mqtt5ClientFilter::Config&)>;
+    using DataInfosList = QList<cc_tools_qt::ToolsDataInfoPtr>;
+    using TimesList = std::vector<std::chrono::milliseconds>;
+
+    ClientSession(const FakeBroker::Config& brokerConfig, const ConfigFunc& configFunc);
+    ~ClientSession();
+
+    // Starts the filter and reports the socket connection
+    void connect();
+    void disconnect();
+
+    // Reports the loss and the restoration of the socket connection
+    // keeping the filter running.
+    void dropConnection();
+    void restoreConnection();
+
+    void publish(const DataSeq& payload, const QVariantMap& props = QVariantMap());
+
+    // Feeds the data sent by the broker to the filter
+    void receive(const DataSeq& data);
+
+    // Advances the virtual time, the broker responses are delivered right
+    // after every expired timeout, i.e. without the virtual time passing.
+    void advance(std::chrono::milliseconds duration);
+
+    void deliverBrokerOutput();
+
+    FakeBroker& broker()
+    {
+        return m_broker;
+    }
+
+    Mqtt5ClientFilter& filter()
+    {
+        return *m_filter;
+    }
+
+    Mqtt5ClientFilterVirtualTimeSource& time()
+    {
+        return *m_time;
+    }
+
+    DataInfosList takeReceived();
+
+    const QStringList& errors() const
+    {
+        return m_errors;
+    }
+
+    // Virtual time since the session creation
+    std::chrono::milliseconds elapsed() const;
+
+    // Times of the PINGREQ messages received by the broker
+    const TimesList& pingTimes() const
+    {
+        return m_pingTimes;
+    }
+
+private:
+    void sendToBroker(const DataSeq& data);
+
+    FakeBroker m_broker;
+    Mqtt5ClientFilterPtr m_filter;
+    Mqtt5ClientFilterVirtualTimeSource* m_time = nullptr;
+    Mqtt5ClientFilterTimeSource::TimePoint m_startTs;
+    DataInfosList m_received;
+    TimesList m_pingTimes;
+    QStringList m_errors;
+    bool m_connected = false;
+};
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
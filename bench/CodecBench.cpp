@@ -0,0 +1,228 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "CodecBench.h"
+
+#include "Verify.h"
+
+#include "Mqtt5ClientFilterBinCodec.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+using Clock = std::chrono::steady_clock;
+
+// Previously used conversion, kept as the baseline
+QByteArray legacyFromHex(const QString& str)
+{
+    QByteArray result;
+    for (auto idx = 0; idx < str.size(); idx += 2) {
+        auto byteStr = str.mid(idx, 2);
+        result.append(static_cast<char>(byteStr.toUInt(nullptr, 16)));
+    }
+
+    return result;
+}
+
+template <typename TFunc>
+void measure(const char* name, std::size_t len, std::size_t iterations, TFunc&& func)
+{
+    std::size_t sink = 0U;
+    auto start = Clock::now();
+    for (auto idx = 0U; idx < iterations; ++idx) {
+        sink += func();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto bytes = static_cast<double>(len) * static_cast<double>(iterations);
+    std::cout << std::left << 
+        std::setw(22) << name << 
+        std::setw(9) << len << 
+        std::right << std::fixed << std::setprecision(1) <<
+        std::setw(14) << ((bytes / elapsed) / (1024.0 * 1024.0)) <<
+        std::setprecision(3) <<
+        std::setw(14) << ((elapsed * 1e9) / static_cast<double>(iterations)) << 
+        "  (" << (sink & 0x1) << ')' << std::endl;
+}
+
+// Verifies the conversion of the "len" random bytes on the current dispatch level
+bool checkHexLength(std::size_t len, std::mt19937& gen)
+{
+    static const char InvalidChars[] = {'g', 'G', 'z', '/', ':', '@', '`', ' ', '\0', '\x80', '\xff'};
+
+    std::vector<std::uint8_t> data(len);
+    for (auto& byte : data) {
+        byte = static_cast<std::uint8_t>(gen());
+    }
+
+    std::string encoded(len * 2U, '\0');
+    std::string expEncoded(len * 2U, '\0');
+    Mqtt5ClientFilterBinCodec::hexEncode(data.data(), data.size(), &encoded[0]);
+    Mqtt5ClientFilterBinCodec::hexEncodeScalar(data.data(), data.size(), &expEncoded[0]);
+    bool ok = verify(encoded == expEncoded, "hex encode matches scalar");
+
+    std::string upper(encoded);
+    std::string mixed(encoded);
+    for (auto idx = 0U; idx < encoded.size(); ++idx) {
+        upper[idx] = static_cast<char>(std::toupper(encoded[idx]));
+        if ((gen() & 0x1U) != 0U) {
+            mixed[idx] = upper[idx];
+        }
+    }
+
+    std::vector<std::uint8_t> decoded(len);
+    for (auto* str : {&encoded, &upper, &mixed}) {
+        std::fill(decoded.begin(), decoded.end(), std::uint8_t(0U));
+        ok = verify(Mqtt5ClientFilterBinCodec::hexDecode(str->data(), str->size(), decoded.data()), "hex decode succeeds") && ok;
+        ok = verify(decoded == data, "hex decode matches data") && ok;
+    }
+
+    // Every position of every lane and tail 
+    for (auto pos = 0U; pos < encoded.size(); ++pos) {
+        for (auto* str : {&encoded, &upper}) {
+            auto invalid = *str;
+            for (auto ch : InvalidChars) {
+                invalid[pos] = ch;
+                ok = verify(!Mqtt5ClientFilterBinCodec::hexDecode(invalid.data(), invalid.size(), decoded.data()), "hex decode rejects invalid char") && ok;
+                ok = verify(!Mqtt5ClientFilterBinCodec::hexDecodeScalar(invalid.data(), invalid.size(), decoded.data()), "scalar hex decode rejects invalid char") && ok;
+            }
+        }
+    }
+
+    if (!encoded.empty()) {
+        ok = verify(!Mqtt5ClientFilterBinCodec::hexDecode(encoded.data(), encoded.size() - 1U, decoded.data()), "hex decode rejects odd length") && ok;
+    }
+
+    return ok;
+}
+
+} // namespace 
+
+bool runCodecChecks()
+{
+    static const std::size_t MaxLen = 70U;
+
+    auto maxLevel = Mqtt5ClientFilterBinCodec::maxDispatchLevel();
+    bool ok = true;
+    for (auto level = 0; level <= maxLevel; ++level) {
+        Mqtt5ClientFilterBinCodec::setDispatchLevel(static_cast<Mqtt5ClientFilterBinCodec::DispatchLevel>(level));
+        ok = verify(Mqtt5ClientFilterBinCodec::dispatchLevel() == level, "dispatch level is forced") && ok;
+
+        std::mt19937 gen(static_cast<std::mt19937::result_type>(level));
+        for (auto len = 0U; len <= MaxLen; ++len) {
+            if (!checkHexLength(len, gen)) {
+                std::cerr << "  dispatch level " << level << ", length " << len << std::endl;
+                ok = false;
+            }
+        }
+    }
+
+    Mqtt5ClientFilterBinCodec::setDispatchLevel(maxLevel);
+    return ok;
+}
+
+void runCodecBenchmarks(std::size_t iterations)
+{
+    std::cout << '\n' << std::left <<
+        std::setw(22) << "codec" << 
+        std::setw(9) << "bytes" << 
+        std::right <<
+        std::setw(14) << "MB/s" << 
+        std::setw(14) << "ns/op" << std::endl;
+
+    for (auto len : {16U, 64U, 1024U}) {
+        std::vector<std::uint8_t> data(len);
+        for (auto idx = 0U; idx < len; ++idx) {
+            data[idx] = static_cast<std::uint8_t>(idx * 31U);
+        }
+
+        auto hexStr = Mqtt5ClientFilterBinCodec::toHex(data.data(), data.size());
+        auto hexChars = hexStr.toStdString();
+        std::vector<std::uint8_t> decoded(len);
+        std::string encoded(len * 2U, '\0');
+
+        measure("hex decode simd", len, iterations, 
+            [&]() 
+            {
+                Mqtt5ClientFilterBinCodec::hexDecode(hexChars.data(), hexChars.size(), decoded.data());
+                return static_cast<std::size_t>(decoded[0]);
+            });
+
+        measure("hex decode scalar", len, iterations, 
+            [&]() 
+            {
+                Mqtt5ClientFilterBinCodec::hexDecodeScalar(hexChars.data(), hexChars.size(), decoded.data());
+                return static_cast<std::size_t>(decoded[0]);
+            });
+
+        measure("hex encode simd", len, iterations, 
+            [&]() 
+            {
+                Mqtt5ClientFilterBinCodec::hexEncode(data.data(), data.size(), &encoded[0]);
+                return static_cast<std::size_t>(encoded[0]);
+            });
+
+        measure("hex encode scalar", len, iterations, 
+            [&]() 
+            {
+                Mqtt5ClientFilterBinCodec::hexEncodeScalar(data.data(), data.size(), &encoded[0]);
+                return static_cast<std::size_t>(encoded[0]);
+            });
+
+        measure("QString fromHex", len, iterations, 
+            [&]() 
+            {
+                return static_cast<std::size_t>(Mqtt5ClientFilterBinCodec::fromHex(hexStr).size());
+            });
+
+        measure("QString legacy", len, iterations, 
+            [&]() 
+            {
+                return static_cast<std::size_t>(legacyFromHex(hexStr).size());
+            });
+
+        auto base64Str = Mqtt5ClientFilterBinCodec::toBase64(data.data(), data.size());
+        measure("base64 decode", len, iterations, 
+            [&]() 
+            {
+                return static_cast<std::size_t>(Mqtt5ClientFilterBinCodec::fromBase64(base64Str).size());
+            });
+    }
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
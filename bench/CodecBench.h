@@ -0,0 +1,39 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+// Microbenchmarks of the binary properties codec compared to
+// the per-character QString based conversion.
+void runCodecBenchmarks(std::size_t iterations);
+
+// Compares the vectorized hex conversion on every dispatch level with
+// the scalar one, returns false when any of the checks fails.
+bool runCodecChecks();
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
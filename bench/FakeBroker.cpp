@@ -0,0 +1,456 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "FakeBroker.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+enum PacketType : std::uint8_t
+{
+    PacketType_Connect = 1,
+    PacketType_Connack = 2,
+    PacketType_Publish = 3,
+    PacketType_Puback = 4,
+    PacketType_Pubrec = 5,
+    PacketType_Pubrel = 6,
+    PacketType_Pubcomp = 7,
+    PacketType_Subscribe = 8,
+    PacketType_Suback = 9,
+    PacketType_Unsubscribe = 10,
+    PacketType_Unsuback = 11,
+    PacketType_Pingreq = 12,
+    PacketType_Pingresp = 13,
+};
+
+enum PropId : std::uint8_t
+{
+    PropId_PayloadFormat = 0x01,
+    PropId_MessageExpiry = 0x02,
+    PropId_ContentType = 0x03,
+    PropId_ResponseTopic = 0x08,
+    PropId_CorrelationData = 0x09,
+    PropId_SubscriptionId = 0x0b,
+    PropId_SessionExpiry = 0x11,
+    PropId_RequestProblemInfo = 0x17,
+    PropId_RequestResponseInfo = 0x19,
+    PropId_ReceiveMax = 0x21,
+    PropId_TopicAliasMax = 0x22,
+    PropId_TopicAlias = 0x23,
+    PropId_UserProperty = 0x26,
+    PropId_MaxPacketSize = 0x27,
+};
+
+// Returns number of bytes used by the encoding, 0 when incomplete
+std::size_t readVarInt(const std::uint8_t* data, std::size_t len, std::size_t& value)
+{
+    value = 0U;
+    for (auto idx = 0U; (idx < len) && (idx < 4U); ++idx) {
+        value |= static_cast<std::size_t>(data[idx] & 0x7fU) << (idx * 7U);
+        if ((data[idx] & 0x80U) == 0U) {
+            return idx + 1U;
+        }
+    }
+
+    return 0U;
+}
+
+// Returns number of bytes used by the property value, 0 when unknown
+std::size_t propValueLen(std::uint8_t id, const std::uint8_t* data, std::size_t len)
+{
+    auto strLen = 
+        [data, len](std::size_t offset) -> std::size_t
+        {
+            if (len < (offset + 2U)) {
+                return len + 1U;
+            }
+
+            return 2U + ((static_cast<std::size_t>(data[offset]) << 8U) | data[offset + 1U]);
+        };
+
+    switch (id) {
+        case PropId_PayloadFormat: return 1U;
+        case PropId_MessageExpiry: return 4U;
+        case PropId_SessionExpiry: return 4U;
+        case PropId_RequestProblemInfo: return 1U;
+        case PropId_RequestResponseInfo: return 1U;
+        case PropId_ReceiveMax: return 2U;
+        case PropId_TopicAliasMax: return 2U;
+        case PropId_MaxPacketSize: return 4U;
+        case PropId_ContentType: return strLen(0U);
+        case PropId_ResponseTopic: return strLen(0U);
+        case PropId_CorrelationData: return strLen(0U);
+        case PropId_TopicAlias: return 2U;
+        case PropId_SubscriptionId: {
+            std::size_t value = 0U;
+            return readVarInt(data, len, value);
+        }
+        case PropId_UserProperty: {
+            auto keyLen = strLen(0U);
+            return keyLen + strLen(keyLen);
+        }
+        default:
+            break;
+    }
+
+    return 0U;
+}
+
+} // namespace 
+
+FakeBroker::FakeBroker(const Config& config) :
+    m_config(config)
+{
+}
+
+void FakeBroker::processClientData(const DataSeq& data)
+{
+    if (m_silent) {
+        return;
+    }
+
+    m_inData.insert(m_inData.end(), data.begin(), data.end());
+
+    std::size_t offset = 0U;
+    while (offset < m_inData.size()) {
+        auto* pkt = m_inData.data() + offset;
+        auto remLen = m_inData.size() - offset;
+        if (remLen < 2U) {
+            break;
+        }
+
+        std::size_t bodyLen = 0U;
+        auto lenBytes = readVarInt(pkt + 1, remLen - 1U, bodyLen);
+        if ((lenBytes == 0U) || (remLen < (1U + lenBytes + bodyLen))) {
+            break;
+        }
+
+        processPacket(pkt[0], pkt + 1 + lenBytes, bodyLen);
+        offset += 1U + lenBytes + bodyLen;
+    }
+
+    m_inData.erase(m_inData.begin(), m_inData.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+FakeBroker::DataSeq FakeBroker::takeOutput()
+{
+    DataSeq result;
+    result.swap(m_output);
+    return result;
+}
+
+FakeBroker::DataSeq FakeBroker::makePublish(const std::string& topic, unsigned qos, const DataSeq& payload, bool withProps, const UserProps& userProps)
+{
+    DataSeq props;
+    if (withProps) {
+        props.push_back(PropId_ContentType);
+        writeStr(props, "application/json");
+        props.push_back(PropId_ResponseTopic);
+        writeStr(props, "bench/response");
+        props.push_back(PropId_CorrelationData);
+        writeStr(props, "01234567");
+        props.push_back(PropId_SubscriptionId);
+        writeVarInt(props, 1U);
+        for (auto* key : {"key1", "key2"}) {
+            props.push_back(PropId_UserProperty);
+            writeStr(props, key);
+            writeStr(props, "value");
+        }
+    }
+
+    for (auto& prop : userProps) {
+        props.push_back(PropId_UserProperty);
+        writeStr(props, prop.first);
+        writeStr(props, prop.second);
+    }
+
+    DataSeq propsLen;
+    writeVarInt(propsLen, props.size());
+
+    std::size_t bodyLen = 2U + topic.size() + propsLen.size() + props.size() + payload.size();
+    if (qos > 0U) {
+        bodyLen += 2U;
+    }
+
+    DataSeq result;
+    result.reserve(bodyLen + 5U);
+    result.push_back(static_cast<std::uint8_t>((PacketType_Publish << 4U) | (qos << 1U)));
+    writeVarInt(result, bodyLen);
+    writeU16(result, static_cast<unsigned>(topic.size()));
+    result.insert(result.end(), topic.begin(), topic.end());
+    if (qos > 0U) {
+        m_nextPacketId = (m_nextPacketId % 0xffffU) + 1U;
+        writeU16(result, m_nextPacketId);
+    }
+    
+    result.insert(result.end(), propsLen.begin(), propsLen.end());
+    result.insert(result.end(), props.begin(), props.end());
+    result.insert(result.end(), payload.begin(), payload.end());
+    return result;
+}
+
+void FakeBroker::processPacket(std::uint8_t typeAndFlags, const std::uint8_t* data, std::size_t len)
+{
+    auto type = static_cast<std::uint8_t>(typeAndFlags >> 4U);
+    auto flags = static_cast<std::uint8_t>(typeAndFlags & 0xfU);
+    switch (type) {
+        case PacketType_Connect:
+            handleConnect(data, len);
+            break;
+        case PacketType_Publish:
+            handlePublish(flags, data, len);
+            break;
+        case PacketType_Pubrec:
+            assert(2U <= len);
+            writeAck(static_cast<std::uint8_t>((PacketType_Pubrel << 4U) | 0x2U), readU16(data));
+            break;
+        case PacketType_Pubrel:
+            assert(2U <= len);
+            writeAck(static_cast<std::uint8_t>(PacketType_Pubcomp << 4U), readU16(data));
+            break;
+        case PacketType_Subscribe:
+            handleSubscribe(data, len);
+            break;
+        case PacketType_Unsubscribe:
+            handleUnsubscribe(data, len);
+            break;
+        case PacketType_Pingreq:
+            ++m_pingsReceived;
+            m_output.push_back(static_cast<std::uint8_t>(PacketType_Pingresp << 4U));
+            m_output.push_back(0U);
+            break;
+        default:
+            break;
+    }
+}
+
+void FakeBroker::sessionOffline(std::chrono::seconds duration)
+{
+    static const std::uint32_t NeverExpires = 0xffffffffU;
+    if ((m_sessionExpiry != NeverExpires) && (std::chrono::seconds(m_sessionExpiry) <= duration)) {
+        m_sessionExists = false;
+    }
+}
+
+void FakeBroker::handleConnect(const std::uint8_t* data, std::size_t len)
+{
+    // Protocol name (6), version (1), flags (1), keep alive (2)
+    static const std::size_t FlagsOffset = 7U;
+    static const std::size_t PropsOffset = 10U;
+    static const std::uint8_t CleanStartFlag = 0x2U;
+
+    assert(PropsOffset < len);
+    bool cleanStart = ((data[FlagsOffset] & CleanStartFlag) != 0U);
+    std::size_t connectPropsLen = 0U;
+    auto offset = PropsOffset + readVarInt(data + PropsOffset, len - PropsOffset, connectPropsLen);
+    assert((offset + connectPropsLen) <= len);
+    auto propsEnd = offset + connectPropsLen;
+    m_sessionExpiry = 0U;
+    while (offset < propsEnd) {
+        auto id = data[offset];
+        ++offset;
+        auto valueLen = propValueLen(id, data + offset, propsEnd - offset);
+        if (valueLen == 0U) {
+            // Not relevant ones follow
+            break;
+        }
+
+        if (id == PropId_SessionExpiry) {
+            m_sessionExpiry = (static_cast<std::uint32_t>(readU16(data + offset)) << 16U) | readU16(data + offset + 2U);
+        }
+
+        offset += valueLen;
+    }
+
+    bool sessionPresent = m_sessionExists && (!cleanStart);
+    m_sessionExists = true;
+    m_topicAliases.clear();
+    DataSeq props;
+    if (m_config.m_receiveMax > 0U) {
+        props.push_back(PropId_ReceiveMax);
+        writeU16(props, m_config.m_receiveMax);
+    }
+
+    if (m_config.m_topicAliasMax > 0U) {
+        props.push_back(PropId_TopicAliasMax);
+        writeU16(props, m_config.m_topicAliasMax);
+    }
+
+    DataSeq propsLen;
+    writeVarInt(propsLen, props.size());
+
+    m_output.push_back(static_cast<std::uint8_t>(PacketType_Connack << 4U));
+    writeVarInt(m_output, 2U + propsLen.size() + props.size());
+    m_output.push_back(sessionPresent ? 1U : 0U);
+    m_output.push_back(0U); // success
+    m_output.insert(m_output.end(), propsLen.begin(), propsLen.end());
+    m_output.insert(m_output.end(), props.begin(), props.end());
+}
+
+void FakeBroker::handlePublish(std::uint8_t flags, const std::uint8_t* data, std::size_t len)
+{
+    ++m_publishesReceived;
+    m_publishBytesReceived += len;
+
+    auto qos = static_cast<unsigned>((flags >> 1U) & 0x3U);
+    assert(2U <= len);
+    auto topicLen = readU16(data);
+    assert((2U + topicLen) <= len);
+    m_lastPublishTopic.assign(data + 2U, data + 2U + topicLen);
+
+    std::size_t offset = 2U + topicLen;
+    unsigned packetId = 0U;
+    if (qos > 0U) {
+        assert((offset + 2U) <= len);
+        packetId = readU16(data + offset);
+        offset += 2U;
+    }
+
+    std::size_t propsLen = 0U;
+    offset += readVarInt(data + offset, len - offset, propsLen);
+    assert((offset + propsLen) <= len);
+    auto propsEnd = offset + propsLen;
+    m_lastPublishTopicAlias = 0U;
+    while (offset < propsEnd) {
+        auto id = data[offset];
+        ++offset;
+        if (id == PropId_TopicAlias) {
+            m_lastPublishTopicAlias = readU16(data + offset);
+        }
+
+        auto valueLen = propValueLen(id, data + offset, propsEnd - offset);
+        assert((0U < valueLen) && ((offset + valueLen) <= propsEnd));
+        offset += valueLen;
+    }
+
+    if (m_lastPublishTopicAlias != 0U) {
+        if (m_lastPublishTopic.empty()) {
+            m_lastPublishTopic = m_topicAliases[m_lastPublishTopicAlias];
+        }
+        else {
+            m_topicAliases[m_lastPublishTopicAlias] = m_lastPublishTopic;
+        }
+    }
+
+    if (qos == 0U) {
+        return;
+    }
+
+    if (qos == 1U) {
+        writeAck(static_cast<std::uint8_t>(PacketType_Puback << 4U), packetId);
+        return;
+    }
+
+    writeAck(static_cast<std::uint8_t>(PacketType_Pubrec << 4U), packetId);
+}
+
+void FakeBroker::handleSubscribe(const std::uint8_t* data, std::size_t len)
+{
+    ++m_subscribesReceived;
+    assert(2U <= len);
+    auto packetId = readU16(data);
+    std::size_t propsLen = 0U;
+    auto propsLenBytes = readVarInt(data + 2U, len - 2U, propsLen);
+    std::size_t offset = 2U + propsLenBytes + propsLen;
+
+    std::size_t count = 0U;
+    while ((offset + 2U) <= len) {
+        offset += 2U + readU16(data + offset) + 1U;
+        ++count;
+    }
+
+    m_output.push_back(static_cast<std::uint8_t>(PacketType_Suback << 4U));
+    writeVarInt(m_output, 2U + 1U + count);
+    writeU16(m_output, packetId);
+    m_output.push_back(0U); // no properties
+    m_output.insert(m_output.end(), count, std::uint8_t(2U)); // granted QoS2
+}
+
+void FakeBroker::handleUnsubscribe(const std::uint8_t* data, std::size_t len)
+{
+    assert(2U <= len);
+    auto packetId = readU16(data);
+    std::size_t propsLen = 0U;
+    auto propsLenBytes = readVarInt(data + 2U, len - 2U, propsLen);
+    std::size_t offset = 2U + propsLenBytes + propsLen;
+
+    std::size_t count = 0U;
+    while ((offset + 2U) <= len) {
+        auto topicLen = readU16(data + offset);
+        offset += 2U;
+        assert((offset + topicLen) <= len);
+        m_unsubscribedTopics.emplace_back(data + offset, data + offset + topicLen);
+        offset += topicLen;
+        ++count;
+    }
+
+    m_output.push_back(static_cast<std::uint8_t>(PacketType_Unsuback << 4U));
+    writeVarInt(m_output, 2U + 1U + count);
+    writeU16(m_output, packetId);
+    m_output.push_back(0U); // no properties
+    m_output.insert(m_output.end(), count, m_unsubscribeReasonCode);
+}
+
+void FakeBroker::writeAck(std::uint8_t typeAndFlags, unsigned packetId)
+{
+    m_output.push_back(typeAndFlags);
+    m_output.push_back(2U);
+    writeU16(m_output, packetId);
+}
+
+void FakeBroker::writeVarInt(DataSeq& buf, std::size_t value)
+{
+    do {
+        auto byte = static_cast<std::uint8_t>(value & 0x7fU);
+        value >>= 7U;
+        if (value != 0U) {
+            byte = static_cast<std::uint8_t>(byte | 0x80U);
+        }
+        buf.push_back(byte);
+    } while (value != 0U);
+}
+
+void FakeBroker::writeU16(DataSeq& buf, unsigned value)
+{
+    buf.push_back(static_cast<std::uint8_t>((value >> 8U) & 0xffU));
+    buf.push_back(static_cast<std::uint8_t>(value & 0xffU));
+}
+
+void FakeBroker::writeStr(DataSeq& buf, const std::string& value)
+{
+    writeU16(buf, static_cast<unsigned>(value.size()));
+    buf.insert(buf.end(), value.begin(), value.end());
+}
+
+unsigned FakeBroker::readU16(const std::uint8_t* data)
+{
+    return (static_cast<unsigned>(data[0]) << 8U) | static_cast<unsigned>(data[1]);
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,157 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+// Minimal MQTT v5 broker stand-in. It parses the packets sent by the client
+// and produces the responses required to complete the operations.
+class FakeBroker
+{
+public:
+    using DataSeq = std::vector<std::uint8_t>;
+
+    struct Config
+    {
+        unsigned m_topicAliasMax = 0U;
+        unsigned m_receiveMax = 0U;
+    };
+
+    explicit FakeBroker(const Config& config);
+
+    // Data written by the client to the socket
+    void processClientData(const DataSeq& data);
+
+    // The silent broker ignores all the received data
+    void setSilent(bool value)
+    {
+        m_silent = value;
+    }
+
+    // Takes the accumulated data to be sent to the client
+    DataSeq takeOutput();
+
+    bool hasOutput() const
+    {
+        return !m_output.empty();
+    }
+
+    using UserProps = std::vector<std::pair<std::string, std::string>>;
+
+    // Encodes PUBLISH sent by the broker to the client, optionally with the
+    // content type, response topic, correlation data, subscription id and user properties.
+    // The explicitly provided user properties are appended.
+    DataSeq makePublish(const std::string& topic, unsigned qos, const DataSeq& payload, bool withProps = false, const UserProps& userProps = UserProps());
+
+    std::size_t publishesReceived() const
+    {
+        return m_publishesReceived;
+    }
+
+    std::size_t publishBytesReceived() const
+    {
+        return m_publishBytesReceived;
+    }
+
+    std::size_t pingsReceived() const
+    {
+        return m_pingsReceived;
+    }
+
+    std::size_t subscribesReceived() const
+    {
+        return m_subscribesReceived;
+    }
+
+    // The client has been offline for the provided duration, the session
+    // is discarded when it exceeds the expiry interval requested on connection.
+    void sessionOffline(std::chrono::seconds duration);
+
+    // Topics of all the received UNSUBSCRIBE messages
+    const std::vector<std::string>& unsubscribedTopics() const
+    {
+        return m_unsubscribedTopics;
+    }
+
+    // Reason code reported for every topic in UNSUBACK
+    void setUnsubscribeReasonCode(std::uint8_t value)
+    {
+        m_unsubscribeReasonCode = value;
+    }
+
+    // Topic of the last received PUBLISH, resolved when only the alias is used
+    const std::string& lastPublishTopic() const
+    {
+        return m_lastPublishTopic;
+    }
+
+    // Topic alias of the last received PUBLISH, 0 when none
+    unsigned lastPublishTopicAlias() const
+    {
+        return m_lastPublishTopicAlias;
+    }
+
+private:
+    void processPacket(std::uint8_t typeAndFlags, const std::uint8_t* data, std::size_t len);
+    void handleConnect(const std::uint8_t* data, std::size_t len);
+    void handlePublish(std::uint8_t flags, const std::uint8_t* data, std::size_t len);
+    void handleSubscribe(const std::uint8_t* data, std::size_t len);
+    void handleUnsubscribe(const std::uint8_t* data, std::size_t len);
+    void writeAck(std::uint8_t typeAndFlags, unsigned packetId);
+
+    static void writeVarInt(DataSeq& buf, std::size_t value);
+    static void writeU16(DataSeq& buf, unsigned value);
+    static void writeStr(DataSeq& buf, const std::string& value);
+    static unsigned readU16(const std::uint8_t* data);
+
+    Config m_config;
+    DataSeq m_inData;
+    DataSeq m_output;
+    std::size_t m_publishesReceived = 0U;
+    std::size_t m_publishBytesReceived = 0U;
+    std::size_t m_pingsReceived = 0U;
+    std::size_t m_subscribesReceived = 0U;
+    std::map<unsigned, std::string> m_topicAliases;
+    std::string m_lastPublishTopic;
+    unsigned m_lastPublishTopicAlias = 0U;
+    std::vector<std::string> m_unsubscribedTopics;
+    std::uint8_t m_unsubscribeReasonCode = 0U;
+    std::uint32_t m_sessionExpiry = 0U;
+    bool m_sessionExists = false;
+    bool m_silent = false;
+    unsigned m_nextPacketId = 0U;
+};
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+
@@ -0,0 +1,254 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "FilterChecks.h"
+
+#include "ClientSession.h"
+
+#include <QtCore/QByteArray>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+using DataSeq = ClientSession::DataSeq;
+
+const QString TopicProp("mqtt5.topic");
+const QString UserPropsProp("mqtt5.user_props");
+
+QVariantMap topicProps(const QString& topic)
+{
+    QVariantMap props;
+    props.insert(TopicProp, topic);
+    return props;
+}
+
+// The topic with the statically configured alias must neither be picked
+// nor released by the automatic allocation.
+bool checkStaticTopicAliasKept()
+{
+    static const QString StaticTopic("check/static/topic/with/long/enough/name");
+    static const QString HotTopic("check/hot/topic/with/long/enough/name");
+    static const QString OtherTopic("check/other/topic/with/long/enough/name");
+    static const std::size_t Window = 128U;
+
+    FakeBroker::Config brokerConfig;
+    brokerConfig.m_topicAliasMax = 4U;
+    ClientSession session(
+        brokerConfig,
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_pubQos = 1;
+            config.m_autoTopicAliases = true;
+            config.m_topicAliases.findOrAppend(StaticTopic);
+        });
+
+    session.connect();
+
+    DataSeq payload(16U, std::uint8_t(0xa5));
+    auto staticProps = topicProps(StaticTopic);
+    auto hotProps = topicProps(HotTopic);
+    auto otherProps = topicProps(OtherTopic);
+
+    // Both topics are hot
+    for (auto idx = 0U; idx < (4U * Window); ++idx) {
+        session.publish(payload, ((idx % 2U) == 0U) ? staticProps : hotProps);
+    }
+
+    session.publish(payload, hotProps);
+    bool ok = verify(session.broker().lastPublishTopicAlias() != 0U, "hot topic gets automatic alias");
+
+    // Both topics go cold
+    for (auto idx = 0U; idx < (12U * Window); ++idx) {
+        session.publish(payload, otherProps);
+    }
+
+    session.publish(payload, hotProps);
+    ok = verify(session.broker().lastPublishTopicAlias() == 0U, "cold topic alias is released") && ok;
+
+    session.publish(payload, staticProps);
+    ok = verify(session.broker().lastPublishTopicAlias() != 0U, "static topic alias survives automatic release") && ok;
+    ok = verify(session.broker().lastPublishTopic() == StaticTopic.toStdString(), "static topic alias is resolved") && ok;
+    ok = verify(session.errors().isEmpty(), "no errors reported") && ok;
+    return ok;
+}
+
+// The topic rejected by the UNSUBACK is still subscribed on the broker and
+// must be unsubscribed again on the next synchronization.
+bool checkFailedUnsubscribeRetried()
+{
+    static const QString KeptTopic("check/kept");
+    static const QString RemovedTopic("check/removed");
+    static const std::uint8_t UnspecifiedError = 0x80;
+
+    ClientSession session(
+        FakeBroker::Config(),
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_subscribes.findOrAppend(KeptTopic);
+            config.m_subscribes.findOrAppend(RemovedTopic);
+        });
+
+    session.connect();
+
+    auto& broker = session.broker();
+    auto& filter = session.filter();
+    broker.setUnsubscribeReasonCode(UnspecifiedError);
+    filter.updateConfig(
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_subscribes.remove(RemovedTopic);
+        });
+    filter.subscribesUpdated();
+    session.deliverBrokerOutput();
+
+    auto& unsubscribed = broker.unsubscribedTopics();
+    bool ok = verify(unsubscribed.size() == 1U, "removed topic is unsubscribed");
+    ok = verify(session.errors().size() == 1, "rejected unsubscribe is reported") && ok;
+
+    broker.setUnsubscribeReasonCode(0U);
+    filter.subscribesUpdated();
+    session.deliverBrokerOutput();
+    ok = verify(unsubscribed.size() == 2U, "rejected unsubscribe is retried") && ok;
+    ok = verify((!unsubscribed.empty()) && (unsubscribed.back() == RemovedTopic.toStdString()), "only removed topic is unsubscribed") && ok;
+
+    filter.subscribesUpdated();
+    session.deliverBrokerOutput();
+    ok = verify(unsubscribed.size() == 2U, "acknowledged unsubscribe is not repeated") && ok;
+    ok = verify(session.errors().size() == 1, "no other errors reported") && ok;
+    return ok;
+}
+
+// The compression marker is internal to the filter, the metrics
+// count both the delivered and the received payload sizes.
+bool checkDecompressedMessage()
+{
+    static const std::string Topic("check/compressed");
+    static const FakeBroker::UserProps::value_type Marker("content-encoding", "qzlib");
+    static const FakeBroker::UserProps::value_type UserProp("key", "value");
+    static const unsigned Qos = 1U;
+
+    ClientSession session(FakeBroker::Config(), [](Mqtt5ClientFilter::Config&) {});
+    session.connect();
+
+    DataSeq payload(1024U, std::uint8_t('a'));
+    auto compressed = qCompress(payload.data(), static_cast<int>(payload.size()));
+    DataSeq compressedPayload(compressed.begin(), compressed.end());
+
+    auto& broker = session.broker();
+    session.receive(broker.makePublish(Topic, Qos, compressedPayload, false, FakeBroker::UserProps{UserProp, Marker}));
+    session.receive(broker.makePublish(Topic, Qos, compressedPayload, false, FakeBroker::UserProps{Marker}));
+    session.deliverBrokerOutput();
+
+    auto received = session.takeReceived();
+    bool ok = verify(received.size() == 2, "compressed messages are received");
+    if (!ok) {
+        return false;
+    }
+
+    for (auto& dataPtr : received) {
+        ok = verify(dataPtr->m_data == payload, "payload is decompressed") && ok;
+    }
+
+    auto userProps = received[0]->m_extraProperties.value(UserPropsProp).toList();
+    ok = verify(userProps.size() == 1, "compression marker is removed") && ok;
+    ok = verify(
+        (!userProps.isEmpty()) && 
+        (userProps[0].toMap().value("key").toString().toStdString() == UserProp.first), 
+        "other user properties are reported") && ok;
+    ok = verify(!received[1]->m_extraProperties.contains(UserPropsProp), "no user properties when only marker") && ok;
+
+    auto metrics = session.filter().metricsSnapshot();
+    auto bytesIn = metrics["bytes_in"].toList().value(Qos).toULongLong();
+    auto wireBytesIn = metrics["wire_bytes_in"].toList().value(Qos).toULongLong();
+    ok = verify(bytesIn == (2U * payload.size()), "received bytes count the delivered payload") && ok;
+    ok = verify(wireBytesIn == (2U * compressedPayload.size()), "received wire bytes count the compressed payload") && ok;
+    ok = verify(metrics["decompressed_msgs"].toULongLong() == 2U, "decompressed messages are counted") && ok;
+    ok = verify(session.errors().isEmpty(), "no errors reported") && ok;
+    return ok;
+}
+
+// Resetting the metrics clears the accumulated counters,
+// but keeps the gauges reflecting the current state.
+bool checkMetricsReset()
+{
+    static const unsigned Qos = 1U;
+
+    ClientSession session(
+        FakeBroker::Config(),
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_pubQos = static_cast<int>(Qos);
+        });
+
+    session.connect();
+
+    DataSeq payload(16U, std::uint8_t(0xa5));
+    session.publish(payload);
+
+    // Stays in flight
+    session.broker().setSilent(true);
+    session.publish(payload);
+
+    auto& filter = session.filter();
+    auto before = filter.metricsSnapshot();
+    bool ok = verify(before["msgs_out"].toList().value(Qos).toULongLong() == 2U, "published messages are counted");
+    ok = verify(before["pub_ack_latency_us"].toMap()["count"].toULongLong() == 1U, "acknowledged publish is counted") && ok;
+
+    QVariantMap props;
+    props.insert("mqtt5.metrics_reset", true);
+    filter.applyInterPluginConfig(props);
+
+    auto after = filter.metricsSnapshot();
+    ok = verify(after["msgs_out"].toList().value(Qos).toULongLong() == 0U, "published messages counter is reset") && ok;
+    ok = verify(after["bytes_out"].toList().value(Qos).toULongLong() == 0U, "published bytes counter is reset") && ok;
+    ok = verify(after["pub_ack_latency_us"].toMap()["count"].toULongLong() == 0U, "latency histogram is reset") && ok;
+    ok = verify(after["in_flight"].toULongLong() == 1U, "in flight gauge is kept") && ok;
+
+    session.broker().setSilent(false);
+    session.publish(payload);
+    auto last = filter.metricsSnapshot();
+    ok = verify(last["msgs_out"].toList().value(Qos).toULongLong() == 1U, "counting continues after reset") && ok;
+    ok = verify(session.errors().isEmpty(), "no errors reported") && ok;
+    return ok;
+}
+
+} // namespace 
+
+bool runFilterChecks()
+{
+    bool ok = true;
+    ok = checkStaticTopicAliasKept() && ok;
+    ok = checkFailedUnsubscribeRetried() && ok;
+    ok = checkDecompressedMessage() && ok;
+    ok = checkMetricsReset() && ok;
+    return ok;
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
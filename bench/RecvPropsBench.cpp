@@ -0,0 +1,194 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "RecvPropsBench.h"
+
+#include "AllocCounter.h"
+
+#include "Mqtt5ClientFilterBinCodec.h"
+#include "Mqtt5ClientFilterStrCache.h"
+
+#include <cc_mqtt5_client/client.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVariantList>
+#include <QtCore/QVariantMap>
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+using Clock = std::chrono::steady_clock;
+
+const QString TopicProp("mqtt5.topic");
+const QString QosProp("mqtt5.qos");
+const QString RetainedProp("mqtt5.retained");
+const QString ContentTypeProp("mqtt5.content_type");
+const QString CorrelationDataProp("mqtt5.correlation_data");
+const QString ResponseTopicProp("mqtt5.response_topic");
+const QString SubIdsProp("mqtt5.sub_ids");
+const QString UserPropsProp("mqtt5.user_props");
+const QString KeySubProp("key");
+const QString ValueSubProp("value");
+
+QVariantMap toVariantMap(const CC_Mqtt5UserProp& prop)
+{
+    QVariantMap map;
+    map[KeySubProp] = QString(prop.m_key);
+    map[ValueSubProp] = QString(prop.m_value);
+    return map;
+}
+
+// Previously used conversion, kept as the baseline
+QVariantMap legacyProps(const CC_Mqtt5MessageInfo& info, const QVariantMap& readProps)
+{
+    QVariantMap props = readProps;
+    props[TopicProp] = info.m_topic;
+    props[QosProp] = static_cast<int>(info.m_qos);
+    props[RetainedProp] = info.m_retained;
+    props[ContentTypeProp] = info.m_contentType;
+    props[CorrelationDataProp] = QByteArray(reinterpret_cast<const char*>(info.m_correlationData), static_cast<int>(info.m_correlationDataLen));
+    props[ResponseTopicProp] = info.m_responseTopic;
+    props[SubIdsProp] = QVariant::fromValue(QList<int>(info.m_subIds, info.m_subIds + info.m_subIdsCount));
+
+    QVariantList userProps;
+    for (auto idx = 0U; idx < info.m_userPropsCount; ++idx) {
+        userProps.append(toVariantMap(info.m_userProps[idx]));
+    }
+
+    props[UserPropsProp] = QVariant::fromValue(userProps);
+    return props;
+}
+
+// Mirrors the conversion of the filter with all the property groups materialized.
+// The copy of the base properties detaches on the first insertion, i.e. every
+// message still gets its own copy of the properties of the socket read.
+QVariantMap currentProps(const CC_Mqtt5MessageInfo& info, const QVariantMap& baseProps, Mqtt5ClientFilterStrCache& strCache)
+{
+    QVariantMap props = baseProps;
+    props.insert(props.cend(), ContentTypeProp, strCache.intern(info.m_contentType));
+    props.insert(props.cend(), CorrelationDataProp, Mqtt5ClientFilterBinCodec::toHex(info.m_correlationData, info.m_correlationDataLen));
+    props.insert(props.cend(), QosProp, static_cast<int>(info.m_qos));
+    props.insert(props.cend(), ResponseTopicProp, strCache.intern(info.m_responseTopic));
+    props.insert(props.cend(), RetainedProp, info.m_retained);
+    props.insert(props.cend(), SubIdsProp, QVariant::fromValue(QList<int>(info.m_subIds, info.m_subIds + info.m_subIdsCount)));
+    props.insert(props.cend(), TopicProp, strCache.intern(info.m_topic));
+
+    QVariantList userProps;
+    userProps.reserve(static_cast<int>(info.m_userPropsCount));
+    for (auto idx = 0U; idx < info.m_userPropsCount; ++idx) {
+        userProps.append(toVariantMap(info.m_userProps[idx]));
+    }
+
+    props.insert(props.cend(), UserPropsProp, QVariant::fromValue(userProps));
+    return props;
+}
+
+template <typename TFunc>
+void measure(const char* name, std::size_t iterations, TFunc&& func)
+{
+    std::size_t sink = 0U;
+    auto allocsBefore = allocCount();
+    auto start = Clock::now();
+    for (auto idx = 0U; idx < iterations; ++idx) {
+        sink += func();
+    }
+    auto elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    auto allocs = allocCount() - allocsBefore;
+
+    std::cout << std::left << 
+        std::setw(24) << name << 
+        std::right << std::fixed << std::setprecision(2) <<
+        std::setw(14) << (static_cast<double>(allocs) / static_cast<double>(iterations)) <<
+        std::setprecision(1) <<
+        std::setw(14) << ((elapsed * 1e9) / static_cast<double>(iterations)) << 
+        "  (" << (sink & 0x1) << ')' << std::endl;
+}
+
+} // namespace 
+
+void runRecvPropsBenchmarks(std::size_t iterations)
+{
+    static const std::uint8_t CorrelationData[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    static const unsigned SubIds[] = {1U};
+    static const CC_Mqtt5UserProp UserProps[] = {
+        {"key1", "value1"},
+        {"key2", "value2"},
+    };
+
+    auto info = CC_Mqtt5MessageInfo();
+    info.m_topic = "bench/some/long/enough/topic/to/benefit/from/alias";
+    info.m_qos = CC_Mqtt5QoS_AtLeastOnceDelivery;
+    info.m_contentType = "application/json";
+    info.m_responseTopic = "bench/response";
+    info.m_correlationData = CorrelationData;
+    info.m_correlationDataLen = static_cast<decltype(info.m_correlationDataLen)>(sizeof(CorrelationData));
+    info.m_subIds = SubIds;
+    info.m_subIdsCount = 1U;
+    info.m_userProps = UserProps;
+    info.m_userPropsCount = 2U;
+
+    // Properties of the socket read shared by all the messages
+    QVariantMap readProps;
+    readProps["from"] = QString("127.0.0.1:1883");
+    readProps["id"] = 1;
+
+    Mqtt5ClientFilterStrCache strCache;
+
+    std::cout << '\n' << std::left <<
+        std::setw(24) << "recv props" << 
+        std::right <<
+        std::setw(14) << "allocs/msg" << 
+        std::setw(14) << "ns/msg" << std::endl;
+
+    measure("legacy", iterations, 
+        [&]()
+        {
+            return static_cast<std::size_t>(legacyProps(info, readProps).size());
+        });
+
+    measure("current", iterations, 
+        [&]()
+        {
+            return static_cast<std::size_t>(currentProps(info, readProps, strCache).size());
+        });
+
+    // The difference with the above is the per message copy of the read properties
+    static const QVariantMap NoReadProps;
+    measure("current, no read props", iterations, 
+        [&]()
+        {
+            return static_cast<std::size_t>(currentProps(info, NoReadProps, strCache).size());
+        });
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
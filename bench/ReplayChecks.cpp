@@ -0,0 +1,190 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "ReplayChecks.h"
+
+#include "ClientSession.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+using DataSeq = ClientSession::DataSeq;
+using Seconds = std::chrono::seconds;
+using Milliseconds = std::chrono::milliseconds;
+
+const unsigned KeepAlive = 60U; // seconds
+const unsigned RespTimeout = 2000U; // ms
+
+// A day of periodic RPC requests, which are never responded. No other packets
+// are sent, the requests are published at the times of the pings, i.e. the
+// pings follow exactly the keep alive period.
+bool checkDayReplay()
+{
+    static const std::chrono::hours Duration(24);
+    static const std::chrono::minutes RequestPeriod(10);
+    static const unsigned RpcTimeout = 5000U; // ms
+    static const unsigned MetricsDumpPeriod = 3600U; // seconds
+
+    ClientSession session(
+        FakeBroker::Config(),
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_keepAlive = KeepAlive;
+            config.m_pubTopic = "replay/request";
+            config.m_respTopic = "replay/response";
+            config.m_rpcTimeout = RpcTimeout;
+            config.m_metricsDumpPeriod = MetricsDumpPeriod;
+        });
+
+    session.connect();
+
+    DataSeq payload(16U, std::uint8_t(0xa5));
+    std::size_t requests = 0U;
+    while (session.elapsed() < Duration) {
+        session.publish(payload);
+        ++requests;
+        session.advance(RequestPeriod);
+    }
+
+    auto& pingTimes = session.pingTimes();
+    auto expectedPings = static_cast<std::size_t>(Seconds(Duration).count() / KeepAlive);
+    bool ok = verify(pingTimes.size() == expectedPings, "keep alive pings count");
+    for (auto idx = 0U; idx < pingTimes.size(); ++idx) {
+        if (pingTimes[idx] != Seconds(KeepAlive * (idx + 1U))) {
+            ok = verify(false, "keep alive ping time");
+            break;
+        }
+    }
+
+    auto metrics = session.filter().metricsSnapshot();
+    auto expectedDumps = static_cast<qulonglong>(Seconds(Duration).count() / MetricsDumpPeriod);
+    ok = verify(metrics["metrics_dumps"].toULongLong() == expectedDumps, "periodic metrics dumps count") && ok;
+    ok = verify(metrics["rpc_requests"].toULongLong() == requests, "RPC requests count") && ok;
+    ok = verify(metrics["rpc_timeouts"].toULongLong() == requests, "all RPC requests time out") && ok;
+
+    auto& errors = session.errors();
+    ok = verify(static_cast<std::size_t>(errors.size()) == requests, "RPC timeouts are reported") && ok;
+    for (auto& msg : errors) {
+        if (!msg.contains("timed out")) {
+            ok = verify(false, "only RPC timeouts are reported");
+            break;
+        }
+    }
+
+    return ok;
+}
+
+// The broker stops responding, the unanswered ping is detected
+// exactly after the response timeout.
+bool checkSilentBroker()
+{
+    ClientSession session(
+        FakeBroker::Config(),
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_keepAlive = KeepAlive;
+            config.m_respTimeout = RespTimeout;
+        });
+
+    session.connect();
+    session.advance(Seconds(KeepAlive));
+    bool ok = verify(session.pingTimes().size() == 1U, "first ping is answered");
+
+    session.broker().setSilent(true);
+    session.advance(Seconds(KeepAlive) + Milliseconds(RespTimeout - 1U));
+    ok = verify(session.errors().isEmpty(), "no error before response timeout") && ok;
+
+    session.advance(Milliseconds(1));
+    auto& errors = session.errors();
+    ok = verify(errors.size() == 1, "response timeout is reported") && ok;
+    ok = verify((!errors.isEmpty()) && errors.front().contains("disconnected"), "broker is reported disconnected") && ok;
+
+    // Waits for the new connection
+    session.publish(DataSeq(16U, std::uint8_t(0xa5)));
+    auto metrics = session.filter().metricsSnapshot();
+    ok = verify(metrics["pending"].toULongLong() == 1U, "publish waits for reconnection") && ok;
+    ok = verify(session.pingTimes().size() == 1U, "no pings after disconnection") && ok;
+    return ok;
+}
+
+// The subscriptions survive the short disconnection, but must be restored
+// after the broker expires the session while the client is offline.
+bool checkSessionExpiry()
+{
+    static const QString Topic("replay/session");
+    static const unsigned SessionExpiry = 300U; // seconds
+    static const Seconds ShortOffline(SessionExpiry / 2U);
+    static const Seconds LongOffline(SessionExpiry * 2U);
+
+    ClientSession session(
+        FakeBroker::Config(),
+        [](Mqtt5ClientFilter::Config& config)
+        {
+            config.m_keepAlive = KeepAlive;
+            config.m_sessionExpiryInterval = SessionExpiry;
+            config.m_subscribes.findOrAppend(Topic);
+        });
+
+    session.connect();
+    auto& broker = session.broker();
+    bool ok = verify(broker.subscribesReceived() == 1U, "topic is subscribed");
+
+    auto offline = 
+        [&session, &broker](Seconds duration)
+        {
+            session.advance(Seconds(KeepAlive * 10U));
+            session.dropConnection();
+            session.advance(duration);
+            broker.sessionOffline(duration);
+            session.restoreConnection();
+        };
+
+    offline(ShortOffline);
+    ok = verify(broker.subscribesReceived() == 1U, "subscription is kept with the session") && ok;
+
+    offline(LongOffline);
+    ok = verify(broker.subscribesReceived() == 2U, "subscription is restored after session expiry") && ok;
+
+    session.advance(Seconds(KeepAlive));
+    ok = verify(broker.subscribesReceived() == 2U, "subscription is restored once") && ok;
+    return ok;
+}
+
+} // namespace 
+
+bool runReplayChecks()
+{
+    bool ok = true;
+    ok = checkDayReplay() && ok;
+    ok = checkSilentBroker() && ok;
+    ok = checkSessionExpiry() && ok;
+    return ok;
+}
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
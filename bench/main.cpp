@@ -0,0 +1,380 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+// Measures throughput and latency of the filter driven headless against
+// the in-process broker stand-in. Usage: <bench> [messages_count]
+// Runs the functional checks instead with: <bench> --check [codec|filter|replay]
+
+#include "AllocCounter.h"
+#include "CodecBench.h"
+#include "FakeBroker.h"
+#include "FilterChecks.h"
+#include "RecvPropsBench.h"
+#include "ReplayChecks.h"
+
+#include "Mqtt5ClientFilter.h"
+
+#include <cc_tools_qt/ToolsDataInfo.h>
+
+#include <QtCore/QCoreApplication>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace bench
+{
+
+namespace 
+{
+
+using Clock = std::chrono::steady_clock;
+using DataSeq = FakeBroker::DataSeq;
+
+const std::string Topic("bench/some/long/enough/topic/to/benefit/from/alias");
+const QString SubTopic("bench/#");
+
+enum Direction
+{
+    Direction_Publish,
+    Direction_Receive,
+};
+
+struct Scenario
+{
+    Direction m_direction = Direction_Publish;
+    unsigned m_qos = 0U;
+    std::size_t m_payloadSize = 0U;
+    bool m_topicAliases = false;
+    std::size_t m_fragmentSize = 0U; // 0 means packet aligned reads
+    bool m_msgProps = false; // received messages carry heavy properties
+    unsigned m_recvPropGroups = Mqtt5ClientFilter::RecvPropGroup_All;
+};
+
+struct Result
+{
+    double m_msgsPerSec = 0.0;
+    double m_bytesPerSec = 0.0;
+    double m_p50Us = 0.0;
+    double m_p99Us = 0.0;
+    double m_allocsPerMsg = 0.0;
+    std::size_t m_errors = 0U;
+};
+
+class Session
+{
+public:
+    explicit Session(const Scenario& scenario) :
+        m_scenario(scenario),
+        m_broker(brokerConfig(scenario)),
+        m_filter(makeMqtt5ClientFilter())
+    {
+        m_filter->updateConfig(
+            [&scenario](Mqtt5ClientFilter::Config& config)
+            {
+                config.m_clientId = "bench";
+                config.m_pubTopic = QString::fromStdString(Topic);
+                config.m_pubQos = static_cast<int>(scenario.m_qos);
+                config.m_recvPropGroups = scenario.m_recvPropGroups;
+                config.m_subscribes.findOrAppend(SubTopic);
+                if (scenario.m_topicAliases) {
+                    config.m_topicAliases.findOrAppend(config.m_pubTopic);
+                }
+            });
+
+        QObject::connect(
+            m_filter.get(), &cc_tools_qt::ToolsFilter::sigDataToSendReport,
+            [this](cc_tools_qt::ToolsDataInfoPtr dataPtr)
+            {
+                m_broker.processClientData(dataPtr->m_data);
+            });
+
+        QObject::connect(
+            m_filter.get(), &cc_tools_qt::ToolsFilter::sigErrorReport,
+            [this](const QString& msg)
+            {
+                ++m_errors;
+                std::cerr << "ERROR: " << msg.toStdString() << std::endl;
+            });
+
+        m_filter->start();
+        m_filter->socketConnectionReport(true);
+        deliverBrokerOutput();
+    }
+
+    ~Session()
+    {
+        m_filter->stop();
+        m_filter->socketConnectionReport(false);
+    }
+
+    Result run(std::size_t count)
+    {
+        DataSeq payload(m_scenario.m_payloadSize, std::uint8_t(0xa5));
+        std::vector<double> latencies;
+        latencies.reserve(count);
+
+        auto allocsBefore = allocCount();
+        auto start = Clock::now();
+        for (auto idx = 0U; idx < count; ++idx) {
+            auto msgStart = Clock::now();
+            if (m_scenario.m_direction == Direction_Publish) {
+                publish(payload);
+            }
+            else {
+                receive(payload);
+            }
+
+            auto msgEnd = Clock::now();
+            latencies.push_back(std::chrono::duration<double, std::micro>(msgEnd - msgStart).count());
+        }
+
+        auto totalSec = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Includes the allocations of the input data produced by the benchmark itself
+        auto allocs = allocCount() - allocsBefore;
+        std::sort(latencies.begin(), latencies.end());
+
+        Result result;
+        result.m_msgsPerSec = static_cast<double>(count) / totalSec;
+        result.m_bytesPerSec = static_cast<double>(count * payload.size()) / totalSec;
+        result.m_allocsPerMsg = static_cast<double>(allocs) / static_cast<double>(count);
+        if (!latencies.empty()) {
+            result.m_p50Us = latencies[(latencies.size() * 50U) / 100U];
+            result.m_p99Us = latencies[(latencies.size() * 99U) / 100U];
+        }
+
+        if (m_scenario.m_direction == Direction_Receive) {
+            result.m_errors = count - std::min(count, m_received);
+        }
+
+        result.m_errors += m_errors;
+        return result;
+    }
+
+private:
+    static FakeBroker::Config brokerConfig(const Scenario& scenario)
+    {
+        FakeBroker::Config config;
+        if (scenario.m_topicAliases) {
+            config.m_topicAliasMax = 10U;
+        }
+        return config;
+    }
+
+    void publish(const DataSeq& payload)
+    {
+        auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+        dataPtr->m_data = payload;
+        auto sent = m_filter->sendData(std::move(dataPtr));
+        for (auto& sentPtr : sent) {
+            m_broker.processClientData(sentPtr->m_data);
+        }
+
+        deliverBrokerOutput();
+    }
+
+    void receive(const DataSeq& payload)
+    {
+        feed(m_broker.makePublish(Topic, m_scenario.m_qos, payload, m_scenario.m_msgProps));
+        deliverBrokerOutput();
+    }
+
+    void deliverBrokerOutput()
+    {
+        while (m_broker.hasOutput()) {
+            feed(m_broker.takeOutput());
+        }
+    }
+
+    void feed(const DataSeq& data)
+    {
+        auto chunkSize = m_scenario.m_fragmentSize;
+        if (chunkSize == 0U) {
+            chunkSize = data.size();
+        }
+
+        for (std::size_t offset = 0U; offset < data.size(); offset += chunkSize) {
+            auto len = std::min(chunkSize, data.size() - offset);
+            auto dataPtr = cc_tools_qt::makeDataInfoTimed();
+            dataPtr->m_data.assign(data.begin() + static_cast<std::ptrdiff_t>(offset), data.begin() + static_cast<std::ptrdiff_t>(offset + len));
+            m_received += static_cast<std::size_t>(m_filter->recvData(std::move(dataPtr)).size());
+        }
+    }
+
+    Scenario m_scenario;
+    FakeBroker m_broker;
+    Mqtt5ClientFilterPtr m_filter;
+    std::size_t m_received = 0U;
+    std::size_t m_errors = 0U;
+};
+
+std::vector<Scenario> allScenarios()
+{
+    static const std::size_t PayloadSizes[] = {16U, 256U, 4096U, 65536U};
+    static const std::size_t FragmentSize = 64U;
+
+    std::vector<Scenario> result;
+    for (auto qos = 0U; qos <= 2U; ++qos) {
+        for (auto payloadSize : PayloadSizes) {
+            for (auto aliases : {false, true}) {
+                Scenario scenario;
+                scenario.m_direction = Direction_Publish;
+                scenario.m_qos = qos;
+                scenario.m_payloadSize = payloadSize;
+                scenario.m_topicAliases = aliases;
+                result.push_back(scenario);
+            }
+
+            for (auto fragmentSize : {std::size_t(0U), FragmentSize}) {
+                Scenario scenario;
+                scenario.m_direction = Direction_Receive;
+                scenario.m_qos = qos;
+                scenario.m_payloadSize = payloadSize;
+                scenario.m_fragmentSize = fragmentSize;
+                result.push_back(scenario);
+            }
+
+            // Materialization of the heavy received properties on and off
+            for (auto groups : {unsigned(Mqtt5ClientFilter::RecvPropGroup_All), 0U}) {
+                Scenario scenario;
+                scenario.m_direction = Direction_Receive;
+                scenario.m_qos = qos;
+                scenario.m_payloadSize = payloadSize;
+                scenario.m_msgProps = true;
+                scenario.m_recvPropGroups = groups;
+                result.push_back(scenario);
+            }
+        }
+    }
+
+    return result;
+}
+
+void printHeader()
+{
+    std::cout << std::left <<
+        std::setw(9) << "dir" << 
+        std::setw(5) << "qos" << 
+        std::setw(9) << "payload" << 
+        std::setw(7) << "alias" << 
+        std::setw(7) << "reads" << 
+        std::setw(7) << "props" << 
+        std::right <<
+        std::setw(14) << "msgs/s" << 
+        std::setw(14) << "MB/s" << 
+        std::setw(11) << "p50(us)" << 
+        std::setw(11) << "p99(us)" << 
+        std::setw(12) << "allocs/msg" << 
+        std::setw(8) << "errors" << std::endl;
+}
+
+void printResult(const Scenario& scenario, const Result& result)
+{
+    std::string reads("-");
+    if (scenario.m_direction == Direction_Receive) {
+        reads = "align";
+        if (scenario.m_fragmentSize > 0U) {
+            reads = "frag";
+        }
+    }
+
+    std::string props("-");
+    if (scenario.m_msgProps) {
+        props = (scenario.m_recvPropGroups == 0U) ? "off" : "on";
+    }
+
+    std::cout << std::left << 
+        std::setw(9) << ((scenario.m_direction == Direction_Publish) ? "publish" : "receive") << 
+        std::setw(5) << scenario.m_qos << 
+        std::setw(9) << scenario.m_payloadSize << 
+        std::setw(7) << (scenario.m_topicAliases ? "on" : "off") << 
+        std::setw(7) << reads << 
+        std::setw(7) << props << 
+        std::right << std::fixed << std::setprecision(1) <<
+        std::setw(14) << result.m_msgsPerSec <<
+        std::setw(14) << (result.m_bytesPerSec / (1024.0 * 1024.0)) <<
+        std::setprecision(2) <<
+        std::setw(11) << result.m_p50Us <<
+        std::setw(11) << result.m_p99Us <<
+        std::setw(12) << result.m_allocsPerMsg <<
+        std::setw(8) << result.m_errors << std::endl;
+}
+
+int runChecks(const std::string& group)
+{
+    bool ok = true;
+    if (group.empty() || (group == "codec")) {
+        ok = runCodecChecks() && ok;
+    }
+
+    if (group.empty() || (group == "filter")) {
+        ok = runFilterChecks() && ok;
+    }
+
+    if (group.empty() || (group == "replay")) {
+        ok = runReplayChecks() && ok;
+    }
+
+    std::cout << (ok ? "All checks passed" : "Some checks FAILED") << std::endl;
+    return ok ? 0 : 1;
+}
+
+} // namespace 
+
+} // namespace bench
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+int main(int argc, char* argv[])
+{
+    using namespace cc_plugin_mqtt5_client_filter::bench;
+
+    QCoreApplication app(argc, argv);
+
+    if ((1 < argc) && (std::strcmp(argv[1], "--check") == 0)) {
+        std::string group;
+        if (2 < argc) {
+            group = argv[2];
+        }
+
+        return runChecks(group);
+    }
+
+    std::size_t count = 10000U;
+    if (1 < argc) {
+        count = static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10));
+    }
+
+    printHeader();
+    for (auto& scenario : allScenarios()) {
+        Session session(scenario);
+        printResult(scenario, session.run(count));
+    }
+
+    runCodecBenchmarks(count * 10U);
+    runRecvPropsBenchmarks(count * 10U);
+    return 0;
+}
@@ -17,17 +17,26 @@
 
 #include "Mqtt5ClientFilter.h"
 
+#include "Mqtt5ClientFilterBinCodec.h"
+#include "Mqtt5ClientFilterSteadyTimeSource.h"
+
 #include <QtCore/QByteArray>
-#include <QtCore/QDateTime>
+#include <QtCore/QJsonDocument>
 #include <QtCore/QList>
+#include <QtCore/QMetaObject>
+#include <QtCore/QStringList>
 #include <QtCore/QVariant>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <limits>
 #include <iostream>
 #include <string>
+#include <utility>
 
 namespace cc_plugin_mqtt5_client_filter
 {
@@ -118,6 +127,30 @@ const QString& userPropsProp()
     return Str;
 }
 
+const QString& userPropsSetProp()
+{
+    static const QString Str("mqtt5.user_props_set");
+    return Str;
+}
+
+const QString& userPropSetsProp()
+{
+    static const QString Str("mqtt5.user_prop_sets");
+    return Str;    
+}
+
+const QString& rpcRequestIdProp()
+{
+    static const QString Str("mqtt5.rpc_request_id");
+    return Str;    
+}
+
+const QString& rpcLatencyProp()
+{
+    static const QString Str("mqtt5.rpc_latency_us");
+    return Str;    
+}
+
 const QString& clientProp()
 {
     static const QString Str("mqtt5.client");
@@ -220,6 +253,30 @@ const QString& aliasSubscribesClearProp()
     return Str;    
 }
 
+const QString& recvPropsProp()
+{
+    static const QString Str("mqtt5.recv_props");
+    return Str;    
+}
+
+const QString& metricsQueryProp()
+{
+    static const QString Str("mqtt5.metrics_query");
+    return Str;    
+}
+
+const QString& metricsProp()
+{
+    static const QString Str("mqtt5.metrics");
+    return Str;    
+}
+
+const QString& metricsResetProp()
+{
+    static const QString Str("mqtt5.metrics_reset");
+    return Str;    
+}
+
 const QString& keySubProp()
 {
     static const QString Str("key");
@@ -263,6 +320,43 @@ const QString& retainHandlingSubProp()
     return Str;
 }
 
+// Compressed payload is marked by the user property,
+// the value indicates qCompress() format.
+const char* const CompressionPropKey = "content-encoding";
+const char* const CompressionPropValue = "qzlib";
+
+bool isCompressionMarker(const CC_Mqtt5UserProp& prop)
+{
+    return 
+        (std::strcmp(prop.m_key, CompressionPropKey) == 0) &&
+        (std::strcmp(prop.m_value, CompressionPropValue) == 0);
+}
+
+bool isCompressed(const CC_Mqtt5MessageInfo& info)
+{
+    for (auto idx = 0U; idx < info.m_userPropsCount; ++idx) {
+        if (isCompressionMarker(info.m_userProps[idx])) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// The qCompress() format starts with the 4 bytes big endian size of the
+// uncompressed data.
+const std::size_t CompressedSizeHeaderLen = 4U;
+
+std::size_t uncompressedSize(const CC_Mqtt5MessageInfo& info)
+{
+    assert(CompressedSizeHeaderLen <= info.m_dataLen);
+    std::size_t result = 0U;
+    for (auto idx = 0U; idx < CompressedSizeHeaderLen; ++idx) {
+        result = (result << 8U) | info.m_data[idx];
+    }
+    return result;
+}
+
 QVariantMap toVariantMap(const CC_Mqtt5UserProp& prop)
 {
     QVariantMap map;
@@ -271,54 +365,132 @@ QVariantMap toVariantMap(const CC_Mqtt5UserProp& prop)
     return map;
 }
 
-QByteArray parseBinDataStr(const QString& str)
+// Inserts the properties of the received message in the ascending order
+// of the keys using the end position as a hint, which avoids the lookup
+// when the base properties don't contain MQTT specific keys.
+// Only the requested groups of the heavy properties are converted, the
+// compression marker is internal to the filter once the payload is decompressed.
+void addMessageProps(const CC_Mqtt5MessageInfo& info, unsigned groups, bool decompressed, Mqtt5ClientFilterStrCache& strCache, QVariantMap& props)
 {
-    QByteArray result;
-    for (auto idx = 0; idx < str.size(); ++idx) {
-        auto byteStr = str.mid(idx, 2);
-        result.append(static_cast<char>(byteStr.toUInt(nullptr, 16)));
+    if ((info.m_contentType != nullptr) && 
+        ((groups & Mqtt5ClientFilter::RecvPropGroup_ContentType) != 0U)) {
+        props.insert(props.cend(), contentTypeProp(), strCache.intern(info.m_contentType));
     }
 
-    return result;
+    if ((info.m_correlationDataLen > 0U) && 
+        ((groups & Mqtt5ClientFilter::RecvPropGroup_CorrelationData) != 0U)) {
+        assert(info.m_correlationData != nullptr);
+        props.insert(props.cend(), correlationDataProp(), Mqtt5ClientFilterBinCodec::toHex(info.m_correlationData, info.m_correlationDataLen));
+    }
+
+    bool formatExpiry = ((groups & Mqtt5ClientFilter::RecvPropGroup_FormatExpiry) != 0U);
+    if ((info.m_messageExpiryInterval != 0U) && formatExpiry) {
+        props.insert(props.cend(), expiryIntervalProp(), static_cast<int>(info.m_messageExpiryInterval));
+    }
+
+    if ((info.m_format != CC_Mqtt5PayloadFormat_Unspecified) && formatExpiry) {
+        props.insert(props.cend(), formatProp(), static_cast<int>(info.m_format));
+    }
+
+    props.insert(props.cend(), qosProp(), static_cast<int>(info.m_qos));
+
+    if ((info.m_responseTopic != nullptr) && 
+        ((groups & Mqtt5ClientFilter::RecvPropGroup_ResponseTopic) != 0U)) {
+        props.insert(props.cend(), responseTopicProp(), strCache.intern(info.m_responseTopic));
+    }
+
+    props.insert(props.cend(), retainedProp(), info.m_retained);
+
+    if ((info.m_subIdsCount > 0U) && 
+        ((groups & Mqtt5ClientFilter::RecvPropGroup_SubIds) != 0U)) {
+        assert(info.m_subIds != nullptr);
+        props.insert(props.cend(), subIdsProp(), QVariant::fromValue(QList<int>(info.m_subIds, info.m_subIds + info.m_subIdsCount)));
+    }
+
+    assert(info.m_topic != nullptr);
+    props.insert(props.cend(), topicProp(), strCache.intern(info.m_topic));
+
+    if ((info.m_userPropsCount > 0U) && 
+        ((groups & Mqtt5ClientFilter::RecvPropGroup_UserProps) != 0U)) {
+        assert(info.m_userProps != nullptr);
+        QVariantList userProps;
+        userProps.reserve(static_cast<int>(info.m_userPropsCount));
+        for (auto idx = 0U; idx < info.m_userPropsCount; ++idx) {
+            auto& prop = info.m_userProps[idx];
+            if (decompressed && isCompressionMarker(prop)) {
+                continue;
+            }
+
+            userProps.append(toVariantMap(prop));
+        }
+
+        if (!userProps.isEmpty()) {
+            props.insert(props.cend(), userPropsProp(), QVariant::fromValue(userProps));
+        }
+    }
 }
 
-std::string getOutgoingTopic(const QVariantMap& props, const QString configVal)
+unsigned parseRecvPropGroups(const QStringList& names)
 {
-    if (props.contains(topicProp())) {
-        return props[topicProp()].value<QString>().toStdString();
-    }
+    static const std::pair<const QString*, unsigned> Map[] = {
+        {&contentTypeProp(), Mqtt5ClientFilter::RecvPropGroup_ContentType},
+        {&correlationDataProp(), Mqtt5ClientFilter::RecvPropGroup_CorrelationData},
+        {&responseTopicProp(), Mqtt5ClientFilter::RecvPropGroup_ResponseTopic},
+        {&subIdsProp(), Mqtt5ClientFilter::RecvPropGroup_SubIds},
+        {&userPropsProp(), Mqtt5ClientFilter::RecvPropGroup_UserProps},
+        {&formatProp(), Mqtt5ClientFilter::RecvPropGroup_FormatExpiry},
+        {&expiryIntervalProp(), Mqtt5ClientFilter::RecvPropGroup_FormatExpiry},
+    };
 
-    if (props.contains(aliasTopicProp())) {
-        return props[aliasTopicProp()].value<QString>().toStdString();
+    unsigned result = 0U;
+    for (auto& n : names) {
+        auto iter = 
+            std::find_if(
+                std::begin(Map), std::end(Map),
+                [&n](auto& elem)
+                {
+                    return *elem.first == n;
+                });
+
+        if (iter != std::end(Map)) {
+            result |= iter->second;
+        }
     }
 
-    return configVal.toStdString();
+    return result;
 }
 
-int getOutgoingQos(const QVariantMap& props, int configVal)
+QByteArray parseBinData(const QVariant& var, bool& ok)
 {
-    if (props.contains(qosProp())) {
-        return props[qosProp()].value<int>();
+    ok = true;
+    if (!var.isValid()) {
+        return QByteArray();
     }
 
-    if (props.contains(aliasQosProp())) {
-        return props[aliasQosProp()].value<int>();
+    if (var.userType() == QMetaType::QByteArray) {
+        return var.toByteArray();
     }
 
-    return configVal;
+    return Mqtt5ClientFilterBinCodec::decode(var.toString(), &ok);
 }
 
-bool getOutgoingRetained(const QVariantMap& props)
+// All the MQTT specific properties share the same prefix
+// and are located next to each other in the sorted map.
+bool hasMqttProps(const QVariantMap& props)
 {
-    if (props.contains(retainedProp())) {
-        return props[retainedProp()].value<bool>();
-    }
+    static const QString Prefix("mqtt");
+    auto iter = props.lowerBound(Prefix);
+    return (iter != props.end()) && iter.key().startsWith(Prefix);
+}
 
-    if (props.contains(aliasRetainedProp())) {
-        return props[aliasRetainedProp()].value<bool>();
-    }    
+QVariant getOutgoingProp(const QVariantMap& props, const QString& name, const QString& aliasName)
+{
+    auto iter = props.constFind(name);
+    if (iter != props.constEnd()) {
+        return *iter;
+    }
 
-    return false;
+    return props.value(aliasName);
 }
 
 const QString& errorCodeStr(CC_Mqtt5ErrorCode ec)
@@ -384,20 +556,36 @@ std::vector<std::uint8_t> parsePassword(const QString& password)
 
     for (auto idx = 0; idx < password.size();) {
         if (((idx + 1) < password.size()) && (password[idx] == '\\') && (password[idx + 1] == '\\')) {
-            result.push_back(static_cast<std::uint8_t>('\''));
+            result.push_back(static_cast<std::uint8_t>('\\'));
             idx += 2;
             continue;
         }
 
-        if ((password.size() <= (idx + 4)) || 
-            (password[idx] != '\\') || 
-            (password[idx + 1] != 'x')) {
+        std::uint8_t byte = 0U;
+        bool escaped = 
+            ((idx + 4) <= password.size()) &&
+            (password[idx] == '\\') &&
+            (password[idx + 1] == 'x');
+
+        if (escaped) {
+            const char hexChars[] = {
+                static_cast<char>(password[idx + 2].cell()), 
+                static_cast<char>(password[idx + 3].cell())
+            };
+
+            escaped = 
+                (password[idx + 2].row() == 0U) && 
+                (password[idx + 3].row() == 0U) && 
+                Mqtt5ClientFilterBinCodec::hexDecode(hexChars, sizeof(hexChars), &byte);
+        }
+
+        if (!escaped) {
             result.push_back(static_cast<std::uint8_t>(password[idx].cell()));
             idx += 1;
             continue;
         }
 
-        result.push_back(static_cast<std::uint8_t>(password.mid(idx + 2, 2).toUInt(nullptr, 16)));
+        result.push_back(byte);
         idx += 4;
     }
 
@@ -408,12 +596,26 @@ std::vector<std::uint8_t> parsePassword(const QString& password)
     
 
 Mqtt5ClientFilter::Mqtt5ClientFilter() :
-    m_client(::cc_mqtt5_client_alloc())
+    m_client(::cc_mqtt5_client_alloc()),
+    m_logger(
+        DebugName, 
+        [this]()
+        {
+            return static_cast<std::uint64_t>(currTimestamp());
+        })
 {
-    m_timer.setSingleShot(true);
+    setTimeSource(std::make_unique<Mqtt5ClientFilterSteadyTimeSource>());
+
+    m_configChangeTimer.setSingleShot(true);
     connect(
-        &m_timer, &QTimer::timeout,
-        this, &Mqtt5ClientFilter::doTick);
+        &m_configChangeTimer, &QTimer::timeout,
+        this, &Mqtt5ClientFilter::flushConfigChanges);
+
+    m_pendingData.setDropHandler(
+        [this](const cc_tools_qt::ToolsDataInfo&, Mqtt5ClientFilterPendingQueue::SpoolId spoolId)
+        {
+            spoolRelease(spoolId);
+        });
 
     ::cc_mqtt5_client_set_send_output_data_callback(m_client.get(), &Mqtt5ClientFilter::sendDataCb, this);
     ::cc_mqtt5_client_set_broker_disconnect_report_callback(m_client.get(), &Mqtt5ClientFilter::brokerDisconnectedCb, this);
@@ -425,28 +627,243 @@ Mqtt5ClientFilter::Mqtt5ClientFilter() :
     m_config.m_respTimeout = ::cc_mqtt5_client_get_default_response_timeout(m_client.get());
 }
 
-Mqtt5ClientFilter::~Mqtt5ClientFilter() noexcept = default;
+Mqtt5ClientFilter::~Mqtt5ClientFilter() noexcept
+{
+    stopWorker();
+}
+
+QVariantMap Mqtt5ClientFilter::metricsSnapshot()
+{
+    // The engine state (queues, spool, caches) is not synchronized
+    QVariantMap result;
+    runEngine(
+        [this, &result]()
+        {
+            result = metricsSnapshotInternal();
+        });
+
+    return result;
+}
+
+void Mqtt5ClientFilter::resetMetrics()
+{
+    runEngine(
+        [this]()
+        {
+            resetMetricsInternal();
+        });
+}
+
+QVariantMap Mqtt5ClientFilter::metricsSnapshotInternal() const
+{
+    auto result = m_metrics.snapshot();
+    result["recv_str_cache_hits"] = static_cast<qulonglong>(m_recvStrCache.hits());
+    result["recv_str_cache_misses"] = static_cast<qulonglong>(m_recvStrCache.misses());
+    result["recv_str_cache_hit_rate"] = m_recvStrCache.hitRate();
+    result["pending_bytes"] = static_cast<qulonglong>(m_pendingData.bytes());
+    result["pending_dropped"] = static_cast<qulonglong>(m_pendingData.dropped());
+    result["pending_dropped_bytes"] = static_cast<qulonglong>(m_pendingData.droppedBytes());
+    result["spool_live"] = static_cast<qulonglong>(m_spool.liveCount());
+    result["spool_used_bytes"] = static_cast<qulonglong>(m_spool.usedBytes());
+    result["topic_aliases_auto"] = static_cast<qulonglong>(m_autoTopicAliases.aliasedCount());
+    result["topic_aliases_bytes_saved"] = static_cast<qulonglong>(m_autoTopicAliases.bytesSaved());
+    result["rpc_outstanding"] = static_cast<qulonglong>(m_rpcRequests.size());
+    return result;
+}
+
+void Mqtt5ClientFilter::resetMetricsInternal()
+{
+    m_metrics.reset();
+    m_recvStrCache.resetStats();
+    m_pendingData.resetStats();
+    m_autoTopicAliases.resetStats();
+    m_inData.resetHighWaterMark();
+    m_metrics.setRecvHighWaterMark(m_inData.highWaterMark());
+}
+
+void Mqtt5ClientFilter::setTimeSource(Mqtt5ClientFilterTimeSourcePtr source)
+{
+    assert(source);
+    assert((!m_tickTimer) || (!m_tickTimer->isActive()));
+
+    // The timers are moved to the worker thread (when enabled), the
+    // handlers are invoked in the context of the timer's thread.
+    // The timers of the previous source are released before the source.
+    m_tickTimer = source->createTimer();
+    m_tickTimer->setTimeoutHandler(
+        [this]()
+        {
+            doTick();
+        });
+
+    m_metricsTimer = source->createTimer();
+    m_metricsTimer->setTimeoutHandler(
+        [this]()
+        {
+            dumpMetrics();
+        });
+
+    m_sendBatchTimer = source->createTimer();
+    m_sendBatchTimer->setTimeoutHandler(
+        [this]()
+        {
+            flushSendBatch();
+        });
+
+    m_rpcTimer = source->createTimer();
+    m_rpcTimer->setTimeoutHandler(
+        [this]()
+        {
+            rpcExpire();
+        });
+
+    m_timeSource = std::move(source);
+}
+
+void Mqtt5ClientFilter::subscribesUpdated()
+{
+    runEngine(
+        [this]()
+        {
+            syncSubscribes();
+        });
+}
 
 bool Mqtt5ClientFilter::startImpl()
+{
+    if (m_config.m_workerThread) {
+        startWorker();
+    }
+
+    bool result = false;
+    runEngine(
+        [this, &result]()
+        {
+            result = doStart();
+        });
+
+    if (!result) {
+        stopWorker();
+    }
+
+    return result;
+}
+
+void Mqtt5ClientFilter::stopImpl()
+{
+    runEngine(
+        [this]()
+        {
+            doStop();
+        });
+
+    stopWorker();
+}
+
+QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::recvDataImpl(cc_tools_qt::ToolsDataInfoPtr dataPtr)
+{
+    QList<cc_tools_qt::ToolsDataInfoPtr> result;
+    runEngine(
+        [this, &result, &dataPtr]()
+        {
+            result = doRecvData(std::move(dataPtr));
+        });
+
+    return result;
+}
+
+QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt::ToolsDataInfoPtr dataPtr)
+{
+    QList<cc_tools_qt::ToolsDataInfoPtr> result;
+    runEngine(
+        [this, &result, &dataPtr]()
+        {
+            result = doSendData(std::move(dataPtr));
+        });
+
+    return result;
+}
+
+void Mqtt5ClientFilter::socketConnectionReportImpl(bool connected)
+{
+    runEngine(
+        [this, connected]()
+        {
+            doSocketConnectionReport(connected);
+        });
+}
+
+void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
+{
+    runEngine(
+        [this, &props]()
+        {
+            doApplyInterPluginConfig(props);
+        });
+}
+
+const char* Mqtt5ClientFilter::debugNameImpl() const
+{
+    return DebugName;
+}
+
+bool Mqtt5ClientFilter::doStart()
 {
     auto ec = ::cc_mqtt5_client_set_default_response_timeout(m_client.get(), m_config.m_respTimeout);
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to update MQTT5 default response timeout"));
+        reportErrorInternal(tr("Failed to update MQTT5 default response timeout"));
         return false;
     }    
 
+    m_inData.setCapacity(m_config.m_recvBufCapacity);
+    m_pendingData.setLimits(m_config.m_pendingCountLimit, m_config.m_pendingBytesLimit);
+    m_pendingData.setDropPolicy(
+        static_cast<Mqtt5ClientFilterPendingQueue::DropPolicy>(
+            std::min(m_config.m_pendingDropPolicy, static_cast<unsigned>(Mqtt5ClientFilterPendingQueue::DropPolicy_ValuesLimit) - 1U)));
+    publishConfigUpdated();
+    m_rpcTimeout = std::chrono::milliseconds(m_config.m_rpcTimeout);
+    m_tickDrift = std::chrono::microseconds(0);
+
+    if (!m_config.m_spoolFile.isEmpty()) {
+        openSpool();
+    }
+
+    if (m_config.m_metricsDumpPeriod > 0U) {
+        m_metricsTimer->start(std::chrono::seconds(m_config.m_metricsDumpPeriod));
+    }
+
     return true; 
 }
 
-void Mqtt5ClientFilter::stopImpl()
+void Mqtt5ClientFilter::doStop()
 {
+    debugLog<1>(Mqtt5ClientFilterLogger::Event_RecvStrCacheHits, m_recvStrCache.hits(), m_recvStrCache.hits() + m_recvStrCache.misses());
+
+    m_metricsTimer->stop();
+    rpcClear();
+
+    if (m_spool.isOpen()) {
+        // Will be recovered from the spool on the next start
+        m_pendingData.clear();
+        m_sendQueue.clear();
+        m_metrics.setPendingCount(0U);
+        m_metrics.setSendQueueDepth(0U);
+    }
+
+    m_spool.close();
+    m_spoolInFlight.clear();
+
+    if (m_config.m_autoTopicAliases) {
+        debugLog<1>(Mqtt5ClientFilterLogger::Event_TopicAliasBytesSaved, m_autoTopicAliases.bytesSaved());
+    }
+
     if (!::cc_mqtt5_client_is_connected(m_client.get())) {
         return;
     }
 
     CC_Mqtt5DisconnectHandle disconnect = ::cc_mqtt5_client_disconnect_prepare(m_client.get(), nullptr);
     if (disconnect == nullptr) {
-        reportError(tr("Failed to allocate DISCONNECT message in MQTT5 client"));
+        reportErrorInternal(tr("Failed to allocate DISCONNECT message in MQTT5 client"));
         return;
     }    
 
@@ -454,108 +871,232 @@ void Mqtt5ClientFilter::stopImpl()
     ::cc_mqtt5_client_disconnect_init_config(&config);
     auto ec = ::cc_mqtt5_client_disconnect_config(disconnect, &config);
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to configure MQTT5 disconnect with error: ") + errorCodeStr(ec));
+        reportErrorInternal(tr("Failed to configure MQTT5 disconnect with error: ") + errorCodeStr(ec));
         return;
     }    
 
     ec = cc_mqtt5_client_disconnect_send(disconnect);
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to send disconnect with error: ") + errorCodeStr(ec));
+        reportErrorInternal(tr("Failed to send disconnect with error: ") + errorCodeStr(ec));
         return;
     }    
+
+    flushSendBatch();
 }
 
-QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::recvDataImpl(cc_tools_qt::ToolsDataInfoPtr dataPtr)
+QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::doRecvData(cc_tools_qt::ToolsDataInfoPtr dataPtr)
 {
     m_recvData.clear();
     m_recvDataPtr = std::move(dataPtr);
-    m_inData.insert(m_inData.end(), m_recvDataPtr->m_data.begin(), m_recvDataPtr->m_data.end());
-    auto consumed = ::cc_mqtt5_client_process_data(m_client.get(), m_inData.data(), static_cast<unsigned>(m_inData.size()));
-    if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): consumed bytes: " << consumed << "/" << m_inData.size() << std::endl;
-    }    
-    assert(consumed <= m_inData.size());
-    m_inData.erase(m_inData.begin(), m_inData.begin() + consumed);
+    m_recvBaseProps = m_recvDataPtr->m_extraProperties;
+
+    // When nothing is buffered, process the received data in place and
+    // keep only the unconsumed tail.
+    auto& data = m_recvDataPtr->m_data;
+    bool inPlace = m_inData.empty();
+    const std::uint8_t* buf = data.data();
+    std::size_t bufLen = data.size();
+    if (!inPlace) {
+        m_inData.append(data.data(), data.size());
+        buf = m_inData.data();
+        bufLen = m_inData.size();
+    }
+
+    auto consumed = ::cc_mqtt5_client_process_data(m_client.get(), buf, static_cast<unsigned>(bufLen));
+    debugLog<3>(Mqtt5ClientFilterLogger::Event_ConsumedBytes, consumed, bufLen);
+    assert(consumed <= bufLen);
+
+    if (inPlace) {
+        m_inData.append(buf + consumed, bufLen - consumed);
+    }
+    else {
+        m_inData.consume(consumed);
+    }
+
+    m_metrics.setRecvHighWaterMark(m_inData.highWaterMark());
+
     m_recvDataPtr.reset();
+    m_recvBaseProps.clear();
     return std::move(m_recvData);
 }
 
-QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt::ToolsDataInfoPtr dataPtr)
+QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::doSendData(cc_tools_qt::ToolsDataInfoPtr dataPtr)
 {
     m_sendData.clear();
 
     if (!m_socketConnected) {
-        reportError(tr("Cannot send MQTT5 data when socket is not connected"));
+        reportErrorInternal(tr("Cannot send MQTT5 data when socket is not connected"));
         return m_sendData;
     }
 
+    auto spoolId = Mqtt5ClientFilterSpool::InvalidId;
+    if (m_spool.isOpen()) {
+        spoolId = spoolMessage(*dataPtr);
+    }
+
     if (!::cc_mqtt5_client_is_connected(m_client.get())) {
-        m_pendingData.push_back(std::move(dataPtr));
+        auto qosVar = getOutgoingProp(dataPtr->m_extraProperties, qosProp(), aliasQosProp());
+        auto qos = qosVar.isValid() ? qosVar.toInt() : publishProfile().m_qos;
+        m_pendingData.push(std::move(dataPtr), qos, spoolId);
+        m_metrics.setPendingCount(m_pendingData.size());
         return m_sendData;
     }
 
+    return publishInternal(std::move(dataPtr), false, spoolId);
+}
+
+QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::publishInternal(cc_tools_qt::ToolsDataInfoPtr dataPtr, bool dequeued, Mqtt5ClientFilterSpool::Id spoolId)
+{
+    m_sendData.clear();
+
+    auto& profile = publishProfile();
     auto& props = dataPtr->m_extraProperties;
-    std::string topic = getOutgoingTopic(props, m_config.m_pubTopic);
-    props[topicProp()] = QString::fromStdString(topic);
-    
-    auto qos = getOutgoingQos(props, m_config.m_pubQos);
-    props[qosProp()] = qos;
+    bool hasOverrides = hasMqttProps(props);
+
+    const std::string* topic = &profile.m_topic;
+    std::string topicOverride;
+    auto qos = profile.m_qos;
+    bool retained = false;
+    if (!hasOverrides) {
+        props.insert(topicProp(), profile.m_topicVar);
+        props.insert(qosProp(), profile.m_qosVar);
+        props.insert(retainedProp(), retained);
+    }
+    else {
+        auto topicVar = getOutgoingProp(props, topicProp(), aliasTopicProp());
+        if (topicVar.isValid()) {
+            auto topicStr = topicVar.toString();
+            topicOverride = topicStr.toStdString();
+            topic = &topicOverride;
+            props.insert(topicProp(), topicStr);
+        }
+        else {
+            props.insert(topicProp(), profile.m_topicVar);
+        }
+
+        auto qosVar = getOutgoingProp(props, qosProp(), aliasQosProp());
+        if (qosVar.isValid()) {
+            qos = qosVar.toInt();
+        }
+        props.insert(qosProp(), qos);
 
-    auto retained = getOutgoingRetained(props);
-    props[retainedProp()] = retained;
+        retained = getOutgoingProp(props, retainedProp(), aliasRetainedProp()).toBool();
+        props.insert(retainedProp(), retained);
+    }
 
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): publish: " << topic << std::endl;
-    }     
+    // Keep the number of the QoS1/2 publishes in flight within the
+    // broker's Receive Maximum, preserving the order of the queued ones.
+    if ((qos > 0) && 
+        ((sendWindow() <= m_inFlight.size()) || ((!dequeued) && (!m_sendQueue.empty())))) {
+        enqueuePublish(std::move(dataPtr), qos, spoolId);
+        return m_sendData;
+    }
+
+    debugLog<2>(Mqtt5ClientFilterLogger::Event_Publish, 0U, 0U, topic->c_str());
 
     CC_Mqtt5ErrorCode ec = CC_Mqtt5ErrorCode_Success;
     CC_Mqtt5PublishHandle publish = ::cc_mqtt5_client_publish_prepare(m_client.get(), &ec);
     if (publish == nullptr) {
-        reportError(tr("Publish allocation failed with error: ") + errorCodeStr(ec));
+        reportErrorInternal(tr("Publish allocation failed with error: ") + errorCodeStr(ec));
+        spoolRelease(spoolId);
         return m_sendData;
     }
 
+    const std::uint8_t* payload = dataPtr->m_data.data();
+    std::size_t payloadLen = dataPtr->m_data.size();
+    QByteArray compressed;
+    if ((m_config.m_compressThreshold > 0U) && (m_config.m_compressThreshold <= payloadLen)) {
+        compressed = qCompress(payload, static_cast<int>(payloadLen), m_config.m_compressLevel);
+        if (static_cast<std::size_t>(compressed.size()) < payloadLen) {
+            m_metrics.messageCompressed(payloadLen, static_cast<std::size_t>(compressed.size()));
+            payload = reinterpret_cast<const std::uint8_t*>(compressed.constData());
+            payloadLen = static_cast<std::size_t>(compressed.size());
+        }
+        else {
+            // Not worth it
+            compressed.clear();
+        }
+    }
+
     auto basicConfig = CC_Mqtt5PublishBasicConfig();
     ::cc_mqtt5_client_publish_init_config_basic(&basicConfig);
 
-    basicConfig.m_topic = topic.c_str();
-    basicConfig.m_data = dataPtr->m_data.data();
-    basicConfig.m_dataLen = static_cast<decltype(basicConfig.m_dataLen)>(dataPtr->m_data.size());
+    basicConfig.m_topic = topic->c_str();
+    basicConfig.m_data = payload;
+    basicConfig.m_dataLen = static_cast<decltype(basicConfig.m_dataLen)>(payloadLen);
     basicConfig.m_qos = static_cast<decltype(basicConfig.m_qos)>(qos);    
     basicConfig.m_retain = retained;
     ec = ::cc_mqtt5_client_publish_config_basic(publish, &basicConfig);
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to configure MQTT5 publish with error: ") + errorCodeStr(ec));
+        reportErrorInternal(tr("Failed to configure MQTT5 publish with error: ") + errorCodeStr(ec));
         ::cc_mqtt5_client_publish_cancel(publish);
+        spoolRelease(spoolId);
         return m_sendData;
     }    
 
-    auto respTopic = m_config.m_respTopic.toStdString();
-    if (props.contains(responseTopicProp())) {
-        respTopic = props.value(responseTopicProp()).toString().toStdString();
+    const char* respTopic = nullptr;
+    if (!profile.m_respTopic.empty()) {
+        respTopic = profile.m_respTopic.c_str();
+    }
+
+    std::string respTopicOverride;
+    std::string contentType;
+    QByteArray correlationData;
+    QVariant formatVar;
+    QVariant expiryIntervalVar;
+    QVariant userPropsVar;
+    QVariant userPropsSetVar;
+    if (hasOverrides) {
+        auto respTopicVar = props.value(responseTopicProp());
+        if (respTopicVar.isValid()) {
+            respTopicOverride = respTopicVar.toString().toStdString();
+            respTopic = respTopicOverride.empty() ? nullptr : respTopicOverride.c_str();
+        }
+
+        contentType = props.value(contentTypeProp()).toString().toStdString();
+        bool correlationDataOk = true;
+        correlationData = parseBinData(props.value(correlationDataProp()), correlationDataOk);
+        if (!correlationDataOk) {
+            reportErrorInternal(tr("Invalid correlation data in message extra properties, ignoring"));
+        }
+
+        formatVar = props.value(formatProp());
+        expiryIntervalVar = props.value(expiryIntervalProp());
+        userPropsVar = props.value(userPropsProp());
+        userPropsSetVar = props.value(userPropsSetProp());
     }
 
-    auto contentType = props.value(contentTypeProp()).toString().toStdString();
+    std::uint64_t rpcId = 0U;
+    if ((m_rpcTimeout.count() > 0) && (respTopic != nullptr)) {
+        rpcId = ++m_rpcNextId;
+        if (correlationData.isEmpty()) {
+            correlationData.resize(sizeof(rpcId));
+            for (auto idx = 0U; idx < sizeof(rpcId); ++idx) {
+                correlationData[static_cast<int>(idx)] = static_cast<char>(rpcId >> ((sizeof(rpcId) - idx - 1U) * 8U));
+            }
 
-    auto correlationData = parseBinDataStr(props.value(correlationDataProp()).toString());
+            props.insert(
+                correlationDataProp(), 
+                Mqtt5ClientFilterBinCodec::toHex(
+                    reinterpret_cast<const std::uint8_t*>(correlationData.constData()), 
+                    static_cast<std::size_t>(correlationData.size())));
+        }
 
-    bool hasFormat = props.contains(formatProp());
-    bool hasExpiryInterval = props.contains(expiryIntervalProp());
+        props.insert(rpcRequestIdProp(), static_cast<qulonglong>(rpcId));
+    }
 
     bool hasExtra = 
-        (!respTopic.empty()) || 
+        (respTopic != nullptr) || 
         (!contentType.empty()) ||
         (!correlationData.isEmpty()) ||
-        (hasFormat) || 
-        (hasExpiryInterval);
+        (formatVar.isValid()) || 
+        (expiryIntervalVar.isValid());
 
     if (hasExtra) {
         auto extraConfig = CC_Mqtt5PublishExtraConfig();
         ::cc_mqtt5_client_publish_init_config_extra(&extraConfig);
         
-        if (!respTopic.empty()) {
-            extraConfig.m_responseTopic = respTopic.c_str();
-        }
+        extraConfig.m_responseTopic = respTopic;
 
         if (!contentType.empty()) {
             extraConfig.m_contentType = contentType.c_str();
@@ -566,21 +1107,50 @@ QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt
             extraConfig.m_correlationDataLen = static_cast<decltype(extraConfig.m_correlationDataLen)>(correlationData.size());
         }
 
-        if (hasFormat) {
-            extraConfig.m_format = static_cast<decltype(extraConfig.m_format)>(props.value(formatProp()).toUInt());
+        if (formatVar.isValid()) {
+            extraConfig.m_format = static_cast<decltype(extraConfig.m_format)>(formatVar.toUInt());
         }
 
-        if (hasExpiryInterval) {
-            extraConfig.m_messageExpiryInterval = props.value(formatProp()).toUInt();
+        if (expiryIntervalVar.isValid()) {
+            extraConfig.m_messageExpiryInterval = expiryIntervalVar.toUInt();
         }        
 
         ec = ::cc_mqtt5_client_publish_config_extra(publish, &extraConfig);
         if (ec != CC_Mqtt5ErrorCode_Success) {
-            reportError(tr("Failed to configure extra properties for MQTT5 publish with error: ") + errorCodeStr(ec));
+            reportErrorInternal(tr("Failed to configure extra properties for MQTT5 publish with error: ") + errorCodeStr(ec));
         }           
     }
 
-    auto userPropsVar = props.value(userPropsProp());
+    if (!compressed.isEmpty()) {
+        CC_Mqtt5UserProp prop;
+        prop.m_key = CompressionPropKey;
+        prop.m_value = CompressionPropValue;
+
+        ec = ::cc_mqtt5_client_publish_add_user_prop(publish, &prop);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            reportErrorInternal(tr("Failed to add publish user property with error: ") + errorCodeStr(ec));
+        }
+    }
+
+    if (userPropsSetVar.isValid()) {
+        auto setIter = profile.m_userPropSets.constFind(userPropsSetVar.toString());
+        if (setIter == profile.m_userPropSets.constEnd()) {
+            reportErrorInternal(tr("Unknown user properties set in message extra properties, ignoring"));
+        }
+        else {
+            for (auto& elem : *setIter) {
+                CC_Mqtt5UserProp prop;
+                prop.m_key = elem.first.c_str();
+                prop.m_value = elem.second.c_str();
+
+                ec = ::cc_mqtt5_client_publish_add_user_prop(publish, &prop);
+                if (ec != CC_Mqtt5ErrorCode_Success) {
+                    reportErrorInternal(tr("Failed to add publish user property with error: ") + errorCodeStr(ec));
+                }
+            }
+        }
+    }
+
     if (userPropsVar.isValid()) {
         auto userProps = userPropsVar.value<QVariantList>();
         for (auto& propMapVar : userProps) {
@@ -589,7 +1159,7 @@ QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt
             auto valueVar = map.value(valueSubProp());
 
             if ((!keyVar.isValid()) || (!valueVar.isValid())) {
-                reportError("Invalid user property configuration in message extra properties, ignoring");
+                reportErrorInternal("Invalid user property configuration in message extra properties, ignoring");
                 continue;
             }
 
@@ -602,7 +1172,7 @@ QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt
 
             ec = ::cc_mqtt5_client_publish_add_user_prop(publish, &prop);
             if (ec != CC_Mqtt5ErrorCode_Success) {
-                reportError(tr("Failed to add publish user property with error: ") + errorCodeStr(ec));
+                reportErrorInternal(tr("Failed to add publish user property with error: ") + errorCodeStr(ec));
                 continue;
             }            
         }
@@ -612,16 +1182,39 @@ QList<cc_tools_qt::ToolsDataInfoPtr> Mqtt5ClientFilter::sendDataImpl(cc_tools_qt
 
     ec = ::cc_mqtt5_client_publish_send(publish, &publishCompleteCb, this);
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to send MQTT5 publish with error: ") + errorCodeStr(ec));
+        reportErrorInternal(tr("Failed to send MQTT5 publish with error: ") + errorCodeStr(ec));
+        spoolRelease(spoolId);
         m_sendDataPtr.reset();
         return m_sendData;        
     }
 
+    m_metrics.messageSent(static_cast<unsigned>(qos), m_sendDataPtr->m_data.size(), payloadLen);
+    if (rpcId != 0U) {
+        rpcRegister(correlationData, rpcId);
+    }
+
+    if (qos > 0) {
+        m_inFlight[publish] = m_timeSource->now();
+        m_metrics.setInFlightCount(m_inFlight.size());
+    }
+
+    // The QoS1/2 publishes remain spooled until acknowledged
+    if ((spoolId != Mqtt5ClientFilterSpool::InvalidId) && (qos > 0)) {
+        m_spoolInFlight[publish] = spoolId;
+    }
+    else {
+        spoolRelease(spoolId);
+    }
+
+    if (m_config.m_autoTopicAliases) {
+        updateAutoTopicAliases(*topic);
+    }
+
     m_sendDataPtr.reset();
     return std::move(m_sendData);
 }
 
-void Mqtt5ClientFilter::socketConnectionReportImpl(bool connected)
+void Mqtt5ClientFilter::doSocketConnectionReport(bool connected)
 {
     m_socketConnected = connected;
     if (connected) {
@@ -632,9 +1225,9 @@ void Mqtt5ClientFilter::socketConnectionReportImpl(bool connected)
     socketDisconnected();
 }
 
-void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
+void Mqtt5ClientFilter::doApplyInterPluginConfig(const QVariantMap& props)
 {
-    bool updated = false;
+    ConfigChanges changes = 0U;
 
     {
         static const QString* ClientProps[] = {
@@ -646,7 +1239,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<QString>())) {
                 m_config.m_clientId = var.value<QString>();
-                updated = true;
+                changes |= ConfigChange_ClientId;
             }
         }
     }
@@ -661,7 +1254,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<QString>())) {
                 m_config.m_username = var.value<QString>();
-                updated = true;
+                changes |= ConfigChange_Username;
             }
         }
     }
@@ -676,7 +1269,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<QString>())) {
                 m_config.m_password = var.value<QString>();
-                updated = true;
+                changes |= ConfigChange_Password;
             }
         }  
     }
@@ -691,7 +1284,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<QString>())) {
                 m_config.m_pubTopic = var.value<QString>();
-                updated = true;
+                changes |= ConfigChange_PubTopic;
             }
         }  
     }  
@@ -706,7 +1299,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<int>())) {
                 m_config.m_pubQos = var.value<int>();
-                updated = true;
+                changes |= ConfigChange_PubQos;
             }
         }  
     }  
@@ -720,51 +1313,97 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             auto var = props.value(*p);
             if ((var.isValid()) && (var.canConvert<QString>())) {
                 m_config.m_respTopic = var.value<QString>();
-                updated = true;
+                changes |= ConfigChange_RespTopic;
             }
         }  
     }     
 
     {
-        static const QString* SubscribesRemoveProps[] = {
-            &aliasSubscribesRemoveProp(),
-            &subscribesRemoveProp(),
-        };
-
-        for (auto* p : SubscribesRemoveProps) {
-            auto var = props.value(*p);
-            if ((!var.isValid()) || (!var.canConvert<QVariantList>())) {
-                continue;
-            }
-
-            auto subList = var.value<QVariantList>();
+        auto var = props.value(recvPropsProp());
+        if ((var.isValid()) && (var.canConvert<QStringList>())) {
+            m_config.m_recvPropGroups = parseRecvPropGroups(var.value<QStringList>());
+            changes |= ConfigChange_RecvProps;
+        }
+    }
 
-            for (auto idx = 0; idx < subList.size(); ++idx) {
-                auto& subVar = subList[idx];
-                if ((!subVar.isValid()) || (!subVar.canConvert<QVariantMap>())) {
+    {
+        auto var = props.value(userPropSetsProp());
+        if ((var.isValid()) && (var.canConvert<QVariantMap>())) {
+            auto setsMap = var.value<QVariantMap>();
+            for (auto iter = setsMap.begin(); iter != setsMap.end(); ++iter) {
+                auto propsList = iter.value().value<QVariantList>();
+                if (propsList.isEmpty()) {
+                    m_config.m_userPropSets.erase(iter.key());
                     continue;
                 }
 
-                auto subMap = subVar.value<QVariantMap>();
-                auto topicVar = subMap.value(topicSubProp());
-                if ((!topicVar.isValid()) || (!topicVar.canConvert<QString>())) {
-                    continue;
+                UserPropsList userProps;
+                userProps.reserve(static_cast<std::size_t>(propsList.size()));
+                for (auto& propVar : propsList) {
+                    auto propMap = propVar.value<QVariantMap>();
+                    auto keyVar = propMap.value(keySubProp());
+                    auto valueVar = propMap.value(valueSubProp());
+                    if ((!keyVar.isValid()) || (!valueVar.isValid())) {
+                        reportErrorInternal(tr("Invalid user property configuration in \"") + userPropSetsProp() + tr("\", ignoring"));
+                        continue;
+                    }
+
+                    userProps.push_back(UserPropConfig{keyVar.toString(), valueVar.toString()});
                 }
 
-                auto topic = topicVar.value<QString>();
+                m_config.m_userPropSets[iter.key()] = std::move(userProps);
+            }
+
+            changes |= ConfigChange_UserPropSets;
+        }
+    }
+
+    {
+        auto var = props.value(metricsQueryProp());
+        if ((var.isValid()) && (var.canConvert<bool>()) && (var.value<bool>())) {
+            QVariantMap reply;
+            reply[metricsProp()] = metricsSnapshotInternal();
+            reportInterPluginConfigInternal(reply);
+        }
+    }
+
+    {
+        // Processed after the query, allows reporting and resetting at once
+        auto var = props.value(metricsResetProp());
+        if ((var.isValid()) && (var.canConvert<bool>()) && (var.value<bool>())) {
+            resetMetricsInternal();
+        }
+    }
+
+    {
+        static const QString* SubscribesRemoveProps[] = {
+            &aliasSubscribesRemoveProp(),
+            &subscribesRemoveProp(),
+        };
+
+        for (auto* p : SubscribesRemoveProps) {
+            auto var = props.value(*p);
+            if ((!var.isValid()) || (!var.canConvert<QVariantList>())) {
+                continue;
+            }
+
+            auto subList = var.value<QVariantList>();
 
-                auto iter = 
-                    std::find_if(
-                        m_config.m_subscribes.begin(), m_config.m_subscribes.end(),
-                        [&topic](const auto& info)
-                        {
-                            return topic == info.m_topic;
-                        });
-                
-                if (iter != m_config.m_subscribes.end()) {
-                    m_config.m_subscribes.erase(iter);
-                    updated = true;
-                    forceCleanStart();                    
+            for (auto idx = 0; idx < subList.size(); ++idx) {
+                auto& subVar = subList[idx];
+                if ((!subVar.isValid()) || (!subVar.canConvert<QVariantMap>())) {
+                    continue;
+                }
+
+                auto subMap = subVar.value<QVariantMap>();
+                auto topicVar = subMap.value(topicSubProp());
+                if ((!topicVar.isValid()) || (!topicVar.canConvert<QString>())) {
+                    continue;
+                }
+
+                auto topic = topicVar.value<QString>();
+                if (m_config.m_subscribes.remove(topic)) {
+                    changes |= ConfigChange_Subscribes;
                 }
             }
         }  
@@ -787,7 +1426,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
             }
 
             m_config.m_subscribes.clear();
-            updated = true;
+            changes |= ConfigChange_Subscribes;
         }  
     }           
 
@@ -805,6 +1444,8 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
 
             auto subList = var.value<QVariantList>();
 
+            // Bulk update in a single pass
+            m_config.m_subscribes.reserve(m_config.m_subscribes.size() + static_cast<std::size_t>(subList.size()));
             for (auto idx = 0; idx < subList.size(); ++idx) {
                 auto& subVar = subList[idx];
                 if ((!subVar.isValid()) || (!subVar.canConvert<QVariantMap>())) {
@@ -817,22 +1458,7 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
                     continue;
                 }
 
-                auto topic = topicVar.value<QString>();
-
-                auto iter = 
-                    std::find_if(
-                        m_config.m_subscribes.begin(), m_config.m_subscribes.end(),
-                        [&topic](const auto& info)
-                        {
-                            return topic == info.m_topic;
-                        });
-                
-                if (iter == m_config.m_subscribes.end()) {
-                    iter = m_config.m_subscribes.insert(m_config.m_subscribes.end(), SubConfig());
-                    iter->m_topic = topic;
-                }
-
-                auto& subConfig = *iter;
+                auto& subConfig = m_config.m_subscribes.findOrAppend(topicVar.value<QString>());
                 auto qosVar = subMap.value(qosSubProp());
                 if (qosVar.isValid() && qosVar.canConvert<int>()) {
                     subConfig.m_maxQos = qosVar.value<int>();
@@ -854,40 +1480,195 @@ void Mqtt5ClientFilter::applyInterPluginConfigImpl(const QVariantMap& props)
                 }                                       
             }
             
-            updated = true;
-            forceCleanStart();
+            changes |= ConfigChange_Subscribes;
         }  
     }              
 
-    if (updated) {
-        emit sigConfigChanged();
+    static const ConfigChanges PublishChanges = 
+        ConfigChange_PubTopic | ConfigChange_PubQos | ConfigChange_RespTopic | ConfigChange_UserPropSets;
+
+    if ((changes & PublishChanges) != 0U) {
+        publishConfigUpdated();
     }
-}
 
-const char* Mqtt5ClientFilter::debugNameImpl() const
-{
-    return "mqtt v5 client filter";
+    if ((changes & ConfigChange_Subscribes) != 0U) {
+        syncSubscribes();
+    }
+
+    reportConfigChanges(changes);
 }
 
 void Mqtt5ClientFilter::doTick()
 {
-    assert(m_tickMeasureTs > 0);
-    m_tickMeasureTs = 0;
+    auto elapsed = tickElapsed();
+    auto reportMs = tickReportMs(elapsed, m_tickMs);
+    auto late = elapsed - std::chrono::microseconds(std::chrono::milliseconds(m_tickMs));
+    m_metrics.tickFired(late.count(), m_tickDrift.count());
 
     assert(m_client);
     if (!m_client) {
         return;
     }
 
-    ::cc_mqtt5_client_tick(m_client.get(), m_tickMs);
+    ::cc_mqtt5_client_tick(m_client.get(), reportMs);
+
+    if (isWorkerThread()) {
+        // Retry delivery of the reports which didn't fit into the queue
+        deliverWorkerReports();
+    }
 }
 
-void Mqtt5ClientFilter::socketConnected()
+void Mqtt5ClientFilter::dumpMetrics()
 {
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket connected report" << std::endl;
+    // Numbers the dumps, i.e. the dropped ones can be detected
+    m_metrics.metricsDumped();
+    auto json = QJsonDocument::fromVariant(metricsSnapshotInternal()).toJson(QJsonDocument::Compact);
+    m_logger.logText(Mqtt5ClientFilterLogger::Event_Metrics, json.toStdString());
+
+    if (m_config.m_metricsDumpPeriod > 0U) {
+        m_metricsTimer->start(std::chrono::seconds(m_config.m_metricsDumpPeriod));
+    }
+}
+
+void Mqtt5ClientFilter::startWorker()
+{
+    if (m_worker) {
+        return;
+    }
+
+    m_workerReports = std::make_unique<WorkerReportsQueue>(WorkerReportsCapacity);
+    m_workerReportsPending = false;
+    m_worker = std::make_unique<Mqtt5ClientFilterWorker>();
+    moveTimersToThread(&m_worker->workerThread());
+    m_worker->start();
+}
+
+void Mqtt5ClientFilter::stopWorker()
+{
+    if (!m_worker) {
+        return;
+    }
+
+    auto* ownerThread = thread();
+    m_worker->exec(
+        [this, ownerThread]()
+        {
+            moveTimersToThread(ownerThread);
+        });
+
+    m_worker->stop();
+    m_worker.reset();
+
+    // The worker thread is finished, deliver everything left behind
+    flushWorkerReports();
+    for (auto& report : m_workerReportsOverflow) {
+        report();
+    }
+
+    m_workerReportsOverflow.clear();
+    m_workerReports.reset();
+}
+
+void Mqtt5ClientFilter::moveTimersToThread(QThread* thread)
+{
+    // The config change notification timer remains on the owner thread
+    Mqtt5ClientFilterTimer* timers[] = {
+        m_tickTimer.get(),
+        m_metricsTimer.get(),
+        m_sendBatchTimer.get(),
+        m_rpcTimer.get(),
+    };
+
+    for (auto* t : timers) {
+        t->moveToThread(thread);
+    }
+}
+
+void Mqtt5ClientFilter::reportErrorInternal(const QString& msg)
+{
+    if (!isWorkerThread()) {
+        reportError(msg);
+        return;
     }
 
+    pushWorkerReport(
+        [this, msg]()
+        {
+            reportError(msg);
+        });
+}
+
+void Mqtt5ClientFilter::reportDataToSendInternal(cc_tools_qt::ToolsDataInfoPtr dataPtr)
+{
+    if (!isWorkerThread()) {
+        reportDataToSend(std::move(dataPtr));
+        return;
+    }
+
+    pushWorkerReport(
+        [this, dataPtr = std::move(dataPtr)]() mutable
+        {
+            reportDataToSend(std::move(dataPtr));
+        });
+}
+
+void Mqtt5ClientFilter::reportInterPluginConfigInternal(const QVariantMap& props)
+{
+    if (!isWorkerThread()) {
+        reportInterPluginConfig(props);
+        return;
+    }
+
+    pushWorkerReport(
+        [this, props]()
+        {
+            reportInterPluginConfig(props);
+        });
+}
+
+void Mqtt5ClientFilter::pushWorkerReport(WorkerReport&& report)
+{
+    m_workerReportsOverflow.push_back(std::move(report));
+    deliverWorkerReports();
+}
+
+void Mqtt5ClientFilter::deliverWorkerReports()
+{
+    assert(m_workerReports);
+    bool delivered = false;
+    while (!m_workerReportsOverflow.empty()) {
+        if (!m_workerReports->push(std::move(m_workerReportsOverflow.front()))) {
+            break;
+        }
+
+        m_workerReportsOverflow.pop_front();
+        delivered = true;
+    }
+
+    // Delivered after the completion of the current synchronous
+    // call or on the next event loop iteration of the owner thread.
+    if (delivered && (!m_workerReportsPending.exchange(true))) {
+        QMetaObject::invokeMethod(this, &Mqtt5ClientFilter::flushWorkerReports, Qt::QueuedConnection);
+    }
+}
+
+void Mqtt5ClientFilter::flushWorkerReports()
+{
+    if (!m_workerReports) {
+        return;
+    }
+
+    m_workerReportsPending = false;
+    WorkerReport report;
+    while (m_workerReports->pop(report)) {
+        report();
+    }
+}
+
+void Mqtt5ClientFilter::socketConnected()
+{
+    debugLog<2>(Mqtt5ClientFilterLogger::Event_SocketConnected);
+
     auto basicConfig = CC_Mqtt5ConnectBasicConfig();
     ::cc_mqtt5_client_connect_init_config_basic(&basicConfig);
 
@@ -928,7 +1709,7 @@ void Mqtt5ClientFilter::socketConnected()
             this);
 
     if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to initiate MQTT v5 connection"));
+        reportErrorInternal(tr("Failed to initiate MQTT v5 connection"));
         return;
     }    
 
@@ -937,43 +1718,461 @@ void Mqtt5ClientFilter::socketConnected()
 
 void Mqtt5ClientFilter::socketDisconnected()
 {
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): socket disconnected report" << std::endl;
-    }
+    debugLog<2>(Mqtt5ClientFilterLogger::Event_SocketDisconnected);
 
+    m_sendBatchTimer->stop();
+    m_sendBatch.reset();
+    releaseAutoTopicAliases();
     ::cc_mqtt5_client_notify_network_disconnected(m_client.get());
+
+    // The queued publishes are sent again after reconnection
+    for (auto& elem : m_sendQueue) {
+        m_pendingData.push(std::move(elem.m_dataPtr), elem.m_qos, elem.m_spoolId);
+    }
+    m_sendQueue.clear();
+    m_inFlight.clear();
+    m_metrics.setSendQueueDepth(0U);
+    m_metrics.setInFlightCount(0U);
+    m_metrics.setPendingCount(m_pendingData.size());
 }
 
 void Mqtt5ClientFilter::sendPendingData()
 {
-    for (auto& dataPtr : m_pendingData) {
-        sendDataImpl(std::move(dataPtr));
+    // Report all the produced data as a single batch
+    m_batchAll = true;
+    m_pendingData.drain(
+        [this](cc_tools_qt::ToolsDataInfoPtr dataPtr, Mqtt5ClientFilterPendingQueue::SpoolId spoolId)
+        {
+            reportPublished(std::move(dataPtr), false, spoolId);
+        });
+    m_batchAll = false;
+    flushSendBatch();
+    m_metrics.setPendingCount(0U);
+}
+
+void Mqtt5ClientFilter::reportPublished(cc_tools_qt::ToolsDataInfoPtr dataPtr, bool dequeued, Mqtt5ClientFilterSpool::Id spoolId)
+{
+    auto dataList = publishInternal(std::move(dataPtr), dequeued, spoolId);
+    for (auto& d : dataList) {
+        reportDataToSendInternal(std::move(d));
+    }
+}
+
+std::size_t Mqtt5ClientFilter::sendWindow() const
+{
+    if (m_brokerReceiveMax == 0U) {
+        return std::numeric_limits<std::uint16_t>::max();
+    }
+
+    return m_brokerReceiveMax;
+}
+
+void Mqtt5ClientFilter::enqueuePublish(cc_tools_qt::ToolsDataInfoPtr dataPtr, int qos, Mqtt5ClientFilterSpool::Id spoolId)
+{
+    if ((m_config.m_sendQueueLimit > 0U) && (m_config.m_sendQueueLimit <= m_sendQueue.size())) {
+        m_metrics.sendQueueDropped();
+        spoolRelease(spoolId);
+        reportErrorInternal(tr("Outgoing MQTT5 publish queue is full, dropping message"));
+        return;
+    }
+
+    m_sendQueue.push_back(QueuedPublish{std::move(dataPtr), m_timeSource->now(), qos, spoolId});
+    m_metrics.setSendQueueDepth(m_sendQueue.size());
+}
+
+void Mqtt5ClientFilter::drainSendQueue()
+{
+    if (m_sendDataPtr) {
+        // Publish is in progress
+        return;
+    }
+
+    auto now = m_timeSource->now();
+    while ((!m_sendQueue.empty()) && 
+           (m_inFlight.size() < sendWindow()) && 
+           (::cc_mqtt5_client_is_connected(m_client.get()))) {
+        auto elem = std::move(m_sendQueue.front());
+        m_sendQueue.pop_front();
+
+        auto wait = std::chrono::duration_cast<std::chrono::microseconds>(now - elem.m_timestamp);
+        m_metrics.sendQueueWaited(static_cast<std::uint64_t>(wait.count()));
+        reportPublished(std::move(elem.m_dataPtr), true, elem.m_spoolId);
+    }
+
+    m_metrics.setSendQueueDepth(m_sendQueue.size());
+}
+
+void Mqtt5ClientFilter::openSpool()
+{
+    Mqtt5ClientFilterSpool::RecoveredList recovered;
+    if (!m_spool.open(m_config.m_spoolFile, m_config.m_spoolSegmentSize, recovered)) {
+        reportErrorInternal(tr("Failed to open MQTT5 spool file: ") + m_config.m_spoolFile);
+        return;
+    }
+
+    // Recovered messages are published after the next successful connection
+    for (auto& elem : recovered) {
+        auto qos = getOutgoingProp(elem.second->m_extraProperties, qosProp(), aliasQosProp()).toInt();
+        m_pendingData.push(std::move(elem.second), qos, elem.first);
+    }
+
+    m_metrics.setPendingCount(m_pendingData.size());
+}
+
+Mqtt5ClientFilterSpool::Id Mqtt5ClientFilter::spoolMessage(const cc_tools_qt::ToolsDataInfo& info)
+{
+    // Spool the resolved topic and QoS, the configuration may change till replay
+    auto props = info.m_extraProperties;
+    auto& profile = publishProfile();
+    if ((!props.contains(topicProp())) && (!props.contains(aliasTopicProp()))) {
+        props.insert(topicProp(), profile.m_topicVar);
+    }
+
+    if ((!props.contains(qosProp())) && (!props.contains(aliasQosProp()))) {
+        props.insert(qosProp(), profile.m_qosVar);
+    }
+
+    auto id = m_spool.append(props, info.m_data);
+    if (id == Mqtt5ClientFilterSpool::InvalidId) {
+        reportErrorInternal(tr("MQTT5 spool is full, the message is not spooled"));
+    }
+
+    return id;
+}
+
+void Mqtt5ClientFilter::spoolReplay(Mqtt5ClientFilterSpool::Id id)
+{
+    // The publish hasn't been acknowledged, the record stays live and
+    // the message is published again.
+    auto dataPtr = m_spool.read(id);
+    if (!dataPtr) {
+        return;
+    }
+
+    auto qos = getOutgoingProp(dataPtr->m_extraProperties, qosProp(), aliasQosProp()).toInt();
+    if (::cc_mqtt5_client_is_connected(m_client.get())) {
+        // Still connected (timed out), retry after the already queued publishes
+        enqueuePublish(std::move(dataPtr), qos, id);
+        return;
+    }
+
+    // Replayed after the next successful connection
+    m_pendingData.push(std::move(dataPtr), qos, id);
+    m_metrics.setPendingCount(m_pendingData.size());
+}
+
+void Mqtt5ClientFilter::spoolRelease(Mqtt5ClientFilterSpool::Id id)
+{
+    if (id == Mqtt5ClientFilterSpool::InvalidId) {
+        return;
     }
-    m_pendingData.clear();
+
+    m_spool.ack(id);
 }
 
 void Mqtt5ClientFilter::registerTopicAliases()
 {
+    m_staticTopicAliases.clear();
     for (auto& info : m_config.m_topicAliases) {
         if (info.m_topic.isEmpty()) {
             continue;
         }
 
         auto topic = info.m_topic.toStdString();
-        ::cc_mqtt5_client_pub_topic_alias_alloc(m_client.get(), topic.c_str(), static_cast<std::uint8_t>(info.m_qos0Rep));
+        auto ec = ::cc_mqtt5_client_pub_topic_alias_alloc(m_client.get(), topic.c_str(), static_cast<std::uint8_t>(info.m_qos0Rep));
+        if (ec == CC_Mqtt5ErrorCode_Success) {
+            m_staticTopicAliases.insert(std::move(topic));
+        }
+    }
+}
+
+void Mqtt5ClientFilter::reportConfigChanges(ConfigChanges changes)
+{
+    if (changes == 0U) {
+        return;
+    }
+
+    if (isWorkerThread()) {
+        // The notification is emitted on the owner thread
+        pushWorkerReport(
+            [this, changes]()
+            {
+                reportConfigChanges(changes);
+            });
+        return;
+    }
+
+    // Coalesce the notifications of the whole event loop iteration
+    m_configChanges |= changes;
+    if (!m_configChangeTimer.isActive()) {
+        m_configChangeTimer.start(0);
+    }
+}
+
+void Mqtt5ClientFilter::syncSubscribes()
+{
+    if (!::cc_mqtt5_client_is_connected(m_client.get())) {
+        // Synchronized when connected
+        return;
+    }
+
+    ActiveSubsMap configured;
+    for (auto& sub : m_config.m_subscribes) {
+        auto topic = sub.m_topic.trimmed().toStdString();
+        if (topic.empty()) {
+            continue;
+        }
+
+        configured[std::move(topic)] = sub;
+    }
+
+    std::vector<std::string> removed;
+    for (auto& activeSub : m_activeSubs) {
+        if (configured.find(activeSub.first) == configured.end()) {
+            removed.push_back(activeSub.first);
+        }
+    }
+
+    std::vector<ActiveSubsMap::const_iterator> added;
+    for (auto iter = configured.cbegin(); iter != configured.cend(); ++iter) {
+        auto activeIter = m_activeSubs.find(iter->first);
+        if (activeIter == m_activeSubs.end()) {
+            added.push_back(iter);
+            continue;
+        }
+
+        auto& active = activeIter->second;
+        auto& sub = iter->second;
+        bool sameOptions = 
+            (active.m_maxQos == sub.m_maxQos) &&
+            (active.m_retainHandling == sub.m_retainHandling) &&
+            (active.m_noLocal == sub.m_noLocal) &&
+            (active.m_retainAsPublished == sub.m_retainAsPublished);
+
+        if (!sameOptions) {
+            // Subscribing again replaces the options
+            added.push_back(iter);
+        }
+    }
+
+    if (!removed.empty()) {
+        unsubscribeTopics(removed);
+    }
+
+    if (added.empty()) {
+        return;
+    }
+
+    CC_Mqtt5SubscribeHandle subscribe = ::cc_mqtt5_client_subscribe_prepare(m_client.get(), nullptr);
+    if (subscribe == nullptr) {
+        reportErrorInternal(tr("Failed to allocate SUBSCRIBE message in MQTT5 client"));
+        return;
+    }    
+
+    std::vector<std::string> topics;
+    topics.reserve(added.size());
+    for (auto iter : added) {
+        auto& sub = iter->second;
+
+        auto topicConfig = CC_Mqtt5SubscribeTopicConfig();
+        ::cc_mqtt5_client_subscribe_init_config_topic(&topicConfig);
+        topicConfig.m_topic = iter->first.c_str();
+        topicConfig.m_maxQos = static_cast<decltype(topicConfig.m_maxQos)>(sub.m_maxQos);
+        topicConfig.m_retainHandling = static_cast<decltype(topicConfig.m_retainHandling)>(sub.m_retainHandling);
+        topicConfig.m_noLocal = sub.m_noLocal;   
+        topicConfig.m_retainAsPublished = sub.m_retainAsPublished;   
+
+        auto ec = ::cc_mqtt5_client_subscribe_config_topic(subscribe, &topicConfig);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            reportErrorInternal(
+                QString("%1 \"%2\", ec=%3").arg(tr("Failed to configure topic")).arg(sub.m_topic).arg(ec));
+            continue;
+        }  
+
+        topics.push_back(iter->first);
+    }
+
+    if (topics.empty()) {
+        ::cc_mqtt5_client_subscribe_cancel(subscribe);
+        return;
+    }
+
+    auto ec = ::cc_mqtt5_client_subscribe_send(subscribe, &Mqtt5ClientFilter::subscribeCompleteCb, this);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        reportErrorInternal(tr("Failed to send MQTT5 SUBSCRIBE message"));
+        return;
+    }    
+
+    for (auto& topic : topics) {
+        m_activeSubs[topic] = configured[topic];
     }
+
+    m_subsInFlight[subscribe] = std::move(topics);
+}
+
+void Mqtt5ClientFilter::unsubscribeTopics(const std::vector<std::string>& topics)
+{
+    CC_Mqtt5UnsubscribeHandle unsubscribe = ::cc_mqtt5_client_unsubscribe_prepare(m_client.get(), nullptr);
+    if (unsubscribe == nullptr) {
+        reportErrorInternal(tr("Failed to allocate UNSUBSCRIBE message in MQTT5 client"));
+        return;
+    }    
+
+    std::vector<const std::string*> configured;
+    configured.reserve(topics.size());
+    for (auto& topic : topics) {
+        auto topicConfig = CC_Mqtt5UnsubscribeTopicConfig();
+        ::cc_mqtt5_client_unsubscribe_init_config_topic(&topicConfig);
+        topicConfig.m_topic = topic.c_str();
+
+        auto ec = ::cc_mqtt5_client_unsubscribe_config_topic(unsubscribe, &topicConfig);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            reportErrorInternal(
+                QString("%1 \"%2\", ec=%3").arg(tr("Failed to configure topic")).arg(topic.c_str()).arg(ec));
+            continue;
+        }  
+
+        configured.push_back(&topic);
+    }
+
+    if (configured.empty()) {
+        ::cc_mqtt5_client_unsubscribe_cancel(unsubscribe);
+        return;
+    }
+
+    auto ec = ::cc_mqtt5_client_unsubscribe_send(unsubscribe, &Mqtt5ClientFilter::unsubscribeCompleteCb, this);
+    if (ec != CC_Mqtt5ErrorCode_Success) {
+        reportErrorInternal(tr("Failed to send MQTT5 UNSUBSCRIBE message"));
+        return;
+    }    
+
+    // Restored when the unsubscribe fails
+    auto& inFlight = m_unsubsInFlight[unsubscribe];
+    inFlight.reserve(configured.size());
+    for (auto* topic : configured) {
+        auto node = m_activeSubs.extract(*topic);
+        assert(!node.empty());
+        inFlight.push_back(std::move(node));
+    }
+}
+
+void Mqtt5ClientFilter::updateAutoTopicAliases(const std::string& topic)
+{
+    // The statically configured aliases are managed by the user only
+    if (m_staticTopicAliases.find(topic) != m_staticTopicAliases.end()) {
+        return;
+    }
+
+    if (!m_autoTopicAliases.record(topic)) {
+        return;
+    }
+
+    std::size_t limit = 0U;
+    if (m_staticTopicAliases.size() < m_brokerTopicAliasMax) {
+        limit = m_brokerTopicAliasMax - m_staticTopicAliases.size();
+    }
+
+    Mqtt5ClientFilterTopicAliasTracker::TopicsList release;
+    Mqtt5ClientFilterTopicAliasTracker::TopicsList allocate;
+    m_autoTopicAliases.evaluate(limit, release, allocate);
+
+    for (auto& t : release) {
+        debugLog<2>(Mqtt5ClientFilterLogger::Event_TopicAliasFree, 0U, 0U, t.c_str());
+        ::cc_mqtt5_client_pub_topic_alias_free(m_client.get(), t.c_str());
+    }
+
+    for (auto& t : allocate) {
+        auto ec = ::cc_mqtt5_client_pub_topic_alias_alloc(m_client.get(), t.c_str(), 1U);
+        if (ec != CC_Mqtt5ErrorCode_Success) {
+            m_autoTopicAliases.allocFailed(t);
+            continue;
+        }
+
+        debugLog<2>(Mqtt5ClientFilterLogger::Event_TopicAliasAlloc, 0U, 0U, t.c_str());
+    }
+}
+
+void Mqtt5ClientFilter::releaseAutoTopicAliases()
+{
+    auto topics = m_autoTopicAliases.dropAliases();
+    for (auto& t : topics) {
+        ::cc_mqtt5_client_pub_topic_alias_free(m_client.get(), t.c_str());
+    }
+}
+
+void Mqtt5ClientFilter::rpcRegister(const QByteArray& key, std::uint64_t id)
+{
+    auto now = m_timeSource->now();
+    m_rpcRequests.insert(key, RpcRequest{id, now});
+    m_rpcDeadlines.push_back(RpcDeadline{now + m_rpcTimeout, key, id});
+    m_metrics.rpcRequested();
+
+    if (!m_rpcTimer->isActive()) {
+        m_rpcTimer->start(m_rpcTimeout);
+    }
+}
+
+void Mqtt5ClientFilter::rpcResponse(const CC_Mqtt5MessageInfo& info, QVariantMap& props)
+{
+    assert(info.m_correlationData != nullptr);
+    auto key = QByteArray::fromRawData(reinterpret_cast<const char*>(info.m_correlationData), static_cast<int>(info.m_correlationDataLen));
+    auto iter = m_rpcRequests.find(key);
+    if (iter == m_rpcRequests.end()) {
+        return;
+    }
+
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(m_timeSource->now() - iter->m_timestamp);
+    m_metrics.rpcResponded(static_cast<std::uint64_t>(latency.count()));
+    props.insert(rpcRequestIdProp(), static_cast<qulonglong>(iter->m_id));
+    props.insert(rpcLatencyProp(), static_cast<qulonglong>(latency.count()));
+    m_rpcRequests.erase(iter);
+}
+
+void Mqtt5ClientFilter::rpcClear()
+{
+    m_rpcTimer->stop();
+    m_rpcRequests.clear();
+    m_rpcDeadlines.clear();
+}
+
+const Mqtt5ClientFilter::PublishProfile& Mqtt5ClientFilter::publishProfile()
+{
+    if (m_pubProfile.m_valid) {
+        return m_pubProfile;
+    }
+
+    m_pubProfile.m_topic = m_config.m_pubTopic.toStdString();
+    m_pubProfile.m_respTopic = m_config.m_respTopic.toStdString();
+    m_pubProfile.m_topicVar = m_config.m_pubTopic;
+    m_pubProfile.m_qosVar = m_config.m_pubQos;
+    m_pubProfile.m_qos = m_config.m_pubQos;
+
+    m_pubProfile.m_userPropSets.clear();
+    for (auto& setElem : m_config.m_userPropSets) {
+        auto& encoded = m_pubProfile.m_userPropSets[setElem.first];
+        encoded.reserve(setElem.second.size());
+        for (auto& prop : setElem.second) {
+            encoded.emplace_back(prop.m_key.toStdString(), prop.m_value.toStdString());
+        }
+    }
+
+    m_pubProfile.m_valid = true;
+    return m_pubProfile;
 }
 
 void Mqtt5ClientFilter::sendDataInternal(const unsigned char* buf, unsigned bufLen)
 {
-    if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): sending " << bufLen << " bytes" << std::endl;
+    debugLog<3>(Mqtt5ClientFilterLogger::Event_Sending, bufLen);
+
+    if ((m_config.m_sendBatchSize > 0U) || m_batchAll) {
+        addToSendBatch(buf, bufLen);
+        return;
     }
 
     auto dataInfo = cc_tools_qt::makeDataInfoTimed();
     dataInfo->m_data.assign(buf, buf + bufLen);
     if (!m_sendDataPtr) {
-        reportDataToSend(std::move(dataInfo));
+        reportDataToSendInternal(std::move(dataInfo));
         return;
     }
 
@@ -981,162 +2180,265 @@ void Mqtt5ClientFilter::sendDataInternal(const unsigned char* buf, unsigned bufL
     m_sendData.append(std::move(dataInfo));
 }
 
-void Mqtt5ClientFilter::brokerDisconnectedInternal()
+void Mqtt5ClientFilter::addToSendBatch(const unsigned char* buf, unsigned bufLen)
 {
-    static const QString BrokerDisconnecteError = 
-        tr("MQTT5 Broker is disconnected");
+    if (!m_sendBatch) {
+        m_sendBatch = cc_tools_qt::makeDataInfoTimed();
+        m_sendBatch->m_data.reserve(m_config.m_sendBatchSize);
+        if (m_sendDataPtr) {
+            m_sendBatch->m_extraProperties = m_sendDataPtr->m_extraProperties;
+        }
+    }
+
+    m_sendBatch->m_data.insert(m_sendBatch->m_data.end(), buf, buf + bufLen);
+    if ((m_config.m_sendBatchSize > 0U) && (m_config.m_sendBatchSize <= m_sendBatch->m_data.size())) {
+        flushSendBatch();
+        return;
+    }
 
-    reportError(BrokerDisconnecteError);
+    if (!m_sendBatchTimer->isActive()) {
+        // Flush at the end of the current event loop iteration
+        m_sendBatchTimer->start(std::chrono::milliseconds(0));
+    }
 }
 
-void Mqtt5ClientFilter::messageReceivedInternal(const CC_Mqtt5MessageInfo& info)
+void Mqtt5ClientFilter::flushSendBatch()
 {
-    if (2 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): app message received: " << info.m_topic << std::endl;
+    m_sendBatchTimer->stop();
+    if (!m_sendBatch) {
+        return;
     }
 
-    assert(m_recvDataPtr);
-    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
-    if (info.m_dataLen > 0U) {
-        dataInfo->m_data.assign(info.m_data, info.m_data + info.m_dataLen);
+    reportDataToSendInternal(std::move(m_sendBatch));
+    m_sendBatch.reset();
+}
+
+void Mqtt5ClientFilter::flushConfigChanges()
+{
+    auto changes = m_configChanges;
+    m_configChanges = 0U;
+    if (changes != 0U) {
+        emit sigConfigChanged(changes);
     }
-    auto& props = dataInfo->m_extraProperties;
-    props = m_recvDataPtr->m_extraProperties;
-    assert(info.m_topic != nullptr);
-    props[topicProp()] = info.m_topic;
-    props[qosProp()] = static_cast<int>(info.m_qos);
-    props[retainedProp()] = info.m_retained;
+}
 
-    if (info.m_contentType != nullptr) {
-        props[contentTypeProp()] = info.m_contentType;
+void Mqtt5ClientFilter::rpcExpire()
+{
+    auto now = m_timeSource->now();
+    while ((!m_rpcDeadlines.empty()) && (m_rpcDeadlines.front().m_deadline <= now)) {
+        auto& deadline = m_rpcDeadlines.front();
+        auto iter = m_rpcRequests.find(deadline.m_key);
+        if ((iter != m_rpcRequests.end()) && (iter->m_id == deadline.m_id)) {
+            m_rpcRequests.erase(iter);
+            m_metrics.rpcTimedOut();
+            reportErrorInternal(tr("MQTT5 RPC request %1 timed out").arg(static_cast<qulonglong>(deadline.m_id)));
+        }
+
+        m_rpcDeadlines.pop_front();
     }
 
-    if (info.m_correlationDataLen > 0U) {
-        assert(info.m_correlationData != nullptr);
-        props[correlationDataProp()] = QByteArray(reinterpret_cast<const char*>(info.m_correlationData), static_cast<int>(info.m_correlationDataLen));
+    if (m_rpcRequests.isEmpty()) {
+        m_rpcDeadlines.clear();
+        return;
     }
 
-    if (info.m_format != CC_Mqtt5PayloadFormat_Unspecified) {
-        props[formatProp()] = static_cast<int>(info.m_format);
+    assert(!m_rpcDeadlines.empty());
+    auto waitMs = std::chrono::ceil<std::chrono::milliseconds>(m_rpcDeadlines.front().m_deadline - now);
+    m_rpcTimer->start(waitMs);
+}
+
+void Mqtt5ClientFilter::brokerDisconnectedInternal()
+{
+    static const QString BrokerDisconnecteError = 
+        tr("MQTT5 Broker is disconnected");
+
+    reportErrorInternal(BrokerDisconnecteError);
+}
+
+bool Mqtt5ClientFilter::decompressPayload(const CC_Mqtt5MessageInfo& info, cc_tools_qt::ToolsDataInfo& dataInfo)
+{
+    static const QString DecompressError = 
+        tr("Failed to decompress received MQTT5 message payload");
+
+    if (info.m_dataLen < CompressedSizeHeaderLen) {
+        reportErrorInternal(DecompressError);
+        return false;
     }
 
-    if (info.m_messageExpiryInterval != 0U) {
-        props[expiryIntervalProp()] = static_cast<int>(info.m_messageExpiryInterval);
+    // The size header is checked before the allocation, qUncompress()
+    // trusts it and keeps growing the buffer when it is too small.
+    auto expectedSize = uncompressedSize(info);
+    if ((m_config.m_decompressMaxSize > 0U) && (m_config.m_decompressMaxSize < expectedSize)) {
+        reportErrorInternal(
+            tr("Received compressed MQTT5 message payload exceeds the maximum size: ") + 
+            QString::number(expectedSize));
+        return false;
     }
 
-    if (info.m_responseTopic != nullptr) {
-        props[responseTopicProp()] = info.m_responseTopic;
+    auto data = qUncompress(info.m_data, static_cast<int>(info.m_dataLen));
+    if (data.isEmpty() || (static_cast<std::size_t>(data.size()) != expectedSize)) {
+        reportErrorInternal(DecompressError);
+        return false;
     }
 
-    if (info.m_subIdsCount > 0U) {
-        assert(info.m_subIds != nullptr);
-        props[subIdsProp()] = QVariant::fromValue(QList<int>(info.m_subIds, info.m_subIds + info.m_subIdsCount));
-    }    
+    m_metrics.messageDecompressed(info.m_dataLen, static_cast<std::size_t>(data.size()));
+    dataInfo.m_data.assign(data.begin(), data.end());
+    return true;
+}
 
-    if (info.m_userPropsCount > 0U) {
-        assert(info.m_userProps != nullptr);
-        QVariantList userProps;
-        for (auto idx = 0U; idx < info.m_userPropsCount; ++idx) {
-            userProps.append(toVariantMap(info.m_userProps[idx]));
-        }
+void Mqtt5ClientFilter::messageReceivedInternal(const CC_Mqtt5MessageInfo& info)
+{
+    debugLog<2>(Mqtt5ClientFilterLogger::Event_MessageReceived, 0U, 0U, info.m_topic);
 
-        props[userPropsProp()] = QVariant::fromValue(userProps);
+    assert(m_recvDataPtr);
+    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
+    bool decompressed = false;
+    if ((info.m_dataLen > 0U) && (info.m_userPropsCount > 0U) && isCompressed(info)) {
+        decompressed = decompressPayload(info, *dataInfo);
     }
 
+    if ((!decompressed) && (info.m_dataLen > 0U)) {
+        dataInfo->m_data.assign(info.m_data, info.m_data + info.m_dataLen);
+    }
+    m_metrics.messageReceived(static_cast<unsigned>(info.m_qos), dataInfo->m_data.size(), info.m_dataLen);
+
+    // Every message gets its own copy of the read properties, the shared map 
+    // detaches on the first insertion.
+    dataInfo->m_extraProperties = m_recvBaseProps;
+    addMessageProps(info, m_config.m_recvPropGroups, decompressed, m_recvStrCache, dataInfo->m_extraProperties);
+    if ((!m_rpcRequests.isEmpty()) && (info.m_correlationDataLen > 0U)) {
+        rpcResponse(info, dataInfo->m_extraProperties);
+    }
     m_recvData.append(std::move(dataInfo));
 }
 
 void Mqtt5ClientFilter::nextTickProgramInternal(unsigned ms)
 {
-    if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): tick request: " << ms << std::endl;
-    }
+    debugLog<3>(Mqtt5ClientFilterLogger::Event_TickRequest, ms);
 
-    assert(!m_timer.isActive());
+    assert(!m_tickTimer->isActive());
     m_tickMs = ms;
-    m_tickMeasureTs = QDateTime::currentMSecsSinceEpoch();
-    m_timer.start(static_cast<int>(ms));
+    m_tickProgramTs = m_timeSource->now();
+    m_tickTimer->start(std::chrono::milliseconds(ms));
 }
 
 unsigned Mqtt5ClientFilter::cancelTickProgramInternal()
 {
-    assert(m_tickMeasureTs > 0);
-    assert(m_timer.isActive());
-    m_timer.stop();
-    auto now = QDateTime::currentMSecsSinceEpoch();
-    assert(m_tickMeasureTs <= now);
-    auto diff = now - m_tickMeasureTs;
-    assert(diff < std::numeric_limits<unsigned>::max());
-    m_tickMeasureTs = 0U;
+    assert(m_tickTimer->isActive());
+    m_tickTimer->stop();
+    auto diff = tickReportMs(tickElapsed(), 0U);
 
-    if (3 <= getDebugOutputLevel()) {
-        std::cout << '[' << currTimestamp() << "] (" << debugNameImpl() << "): cancel tick: " << diff << std::endl;
-    }
-    return static_cast<unsigned>(diff);
+    debugLog<3>(Mqtt5ClientFilterLogger::Event_TickCancel, diff);
+    return diff;
+}
+
+std::chrono::microseconds Mqtt5ClientFilter::tickElapsed()
+{
+    assert(m_tickProgramTs != Clock::time_point());
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(m_timeSource->now() - m_tickProgramTs);
+    m_tickProgramTs = Clock::time_point();
+    return elapsed;
+}
+
+unsigned Mqtt5ClientFilter::tickReportMs(std::chrono::microseconds elapsed, unsigned minMs)
+{
+    // The client accepts whole milliseconds, the remainder is carried over to the
+    // next report. Reporting at least the programmed wait when the timer fires
+    // slightly early results in negative drift, compensated the same way.
+    auto total = elapsed + m_tickDrift;
+    auto reported = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(total), std::chrono::milliseconds(minMs));
+    assert(reported.count() < std::numeric_limits<unsigned>::max());
+    m_tickDrift = total - reported;
+    return static_cast<unsigned>(reported.count());
 }
 
 void Mqtt5ClientFilter::connectCompleteInternal(CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5ConnectResponse* response)
 {
     if (status != CC_Mqtt5AsyncOpStatus_Complete) {
-        reportError(tr("Failed to connect to MQTT5 broker with status: ") + statusStr(status));
+        reportErrorInternal(tr("Failed to connect to MQTT5 broker with status: ") + statusStr(status));
         return;
     }
 
     assert(response != nullptr);
     if (response->m_reasonCode != CC_Mqtt5ReasonCode_Success) {
-        reportError(tr("MQTT broker rejected connection with reasonCode=") + QString::number(response->m_reasonCode));
+        reportErrorInternal(tr("MQTT broker rejected connection with reasonCode=") + QString::number(response->m_reasonCode));
         return;        
     }
 
     m_firstConnect = false;
+    m_brokerTopicAliasMax = response->m_topicAliasMax;
+    m_brokerReceiveMax = response->m_highQosSendLimit;
 
     registerTopicAliases();
     sendPendingData();
 
-    if (response->m_sessionPresent) {
-        return;
+    if (!response->m_sessionPresent) {
+        // Nothing is subscribed on the broker
+        m_activeSubs.clear();
+        m_subsInFlight.clear();
+        m_unsubsInFlight.clear();
     }
 
-    if (m_config.m_subscribes.empty()) {
-        return;
-    }
+    // Subscribes could be updated while disconnected
+    syncSubscribes();
+}
 
-    CC_Mqtt5SubscribeHandle subscribe = ::cc_mqtt5_client_subscribe_prepare(m_client.get(), nullptr);
-    if (subscribe == nullptr) {
-        reportError(tr("Failed to allocate SUBSCRIBE message in MQTT5 client"));
-        return;
-    }    
+void Mqtt5ClientFilter::subscribeCompleteInternal(CC_Mqtt5SubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5SubscribeResponse* response)
+{
+    std::vector<std::string> topics;
+    auto inFlightIter = m_subsInFlight.find(handle);
+    if (inFlightIter != m_subsInFlight.end()) {
+        topics = std::move(inFlightIter->second);
+        m_subsInFlight.erase(inFlightIter);
+    }
 
-    for (auto& sub : m_config.m_subscribes) {
-        auto topicStr = sub.m_topic.trimmed().toStdString();
+    if (status != CC_Mqtt5AsyncOpStatus_Complete) {
+        // Will be subscribed again on the next synchronization
+        for (auto& topic : topics) {
+            m_activeSubs.erase(topic);
+        }
 
-        auto topicConfig = CC_Mqtt5SubscribeTopicConfig();
-        ::cc_mqtt5_client_subscribe_init_config_topic(&topicConfig);
-        topicConfig.m_topic = topicStr.c_str();
-        topicConfig.m_maxQos = static_cast<decltype(topicConfig.m_maxQos)>(sub.m_maxQos);
-        topicConfig.m_retainHandling = static_cast<decltype(topicConfig.m_retainHandling)>(sub.m_retainHandling);
-        topicConfig.m_noLocal = sub.m_noLocal;   
-        topicConfig.m_retainAsPublished = sub.m_retainAsPublished;   
+        reportErrorInternal(tr("Failed to subsribe to MQTT5 topics with status: ") + statusStr(status));
+        return;
+    }  
 
-        auto ec = ::cc_mqtt5_client_subscribe_config_topic(subscribe, &topicConfig);
-        if (ec != CC_Mqtt5ErrorCode_Success) {
-            reportError(
-                QString("%1 \"%2\", ec=%3").arg(tr("Failed to configure topic")).arg(sub.m_topic).arg(ec));
+    assert (response != nullptr);
+    for (auto idx = 0U; idx < response->m_reasonCodesCount; ++idx) {
+        if (response->m_reasonCodes[idx] < CC_Mqtt5ReasonCode_UnspecifiedError) {
             continue;
-        }  
-    }
+        }
 
-    auto ec = cc_mqtt5_client_subscribe_send(subscribe, &Mqtt5ClientFilter::subscribeCompleteCb, this);
-    if (ec != CC_Mqtt5ErrorCode_Success) {
-        reportError(tr("Failed to send MQTT5 SUBSCRIBE message"));
-        return;
-    }    
+        if (idx < topics.size()) {
+            m_activeSubs.erase(topics[idx]);
+        }
+
+        reportErrorInternal(tr("MQTT broker rejected subscribe with reasonCode=") + QString::number(response->m_reasonCodes[idx]));
+    }       
 }
 
-void Mqtt5ClientFilter::subscribeCompleteInternal([[maybe_unused]] CC_Mqtt5SubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5SubscribeResponse* response)
+void Mqtt5ClientFilter::unsubscribeCompleteInternal(CC_Mqtt5UnsubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5UnsubscribeResponse* response)
 {
+    std::vector<ActiveSubsMap::node_type> subs;
+    auto inFlightIter = m_unsubsInFlight.find(handle);
+    if (inFlightIter != m_unsubsInFlight.end()) {
+        subs = std::move(inFlightIter->second);
+        m_unsubsInFlight.erase(inFlightIter);
+    }
+
+    // Still subscribed on the broker, will be unsubscribed again on the next 
+    // synchronization unless subscribed again in the meantime.
+    auto restore = 
+        [this](ActiveSubsMap::node_type& sub)
+        {
+            m_activeSubs.insert(std::move(sub));
+        };
+
     if (status != CC_Mqtt5AsyncOpStatus_Complete) {
-        reportError(tr("Failed to subsribe to MQTT5 topics with status: ") + statusStr(status));
+        for (auto& sub : subs) {
+            restore(sub);
+        }
+
+        reportErrorInternal(tr("Failed to unsubsribe from MQTT5 topics with status: ") + statusStr(status));
         return;
     }  
 
@@ -1146,14 +2448,48 @@ void Mqtt5ClientFilter::subscribeCompleteInternal([[maybe_unused]] CC_Mqtt5Subsc
             continue;
         }
 
-        reportError(tr("MQTT broker rejected subscribe with reasonCode=") + QString::number(response->m_reasonCodes[idx]));
+        if (idx < subs.size()) {
+            restore(subs[idx]);
+        }
+
+        reportErrorInternal(tr("MQTT broker rejected unsubscribe with reasonCode=") + QString::number(response->m_reasonCodes[idx]));
     }       
 }
 
-void Mqtt5ClientFilter::publishCompleteInternal([[maybe_unused]] CC_Mqtt5PublishHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response)
+void Mqtt5ClientFilter::publishCompleteInternal(CC_Mqtt5PublishHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response)
 {
+    auto spoolIter = m_spoolInFlight.find(handle);
+    if (spoolIter != m_spoolInFlight.end()) {
+        auto spoolId = spoolIter->second;
+        m_spoolInFlight.erase(spoolIter);
+        bool retry = 
+            (status == CC_Mqtt5AsyncOpStatus_Timeout) ||
+            ((status != CC_Mqtt5AsyncOpStatus_Complete) && (!::cc_mqtt5_client_is_connected(m_client.get())));
+
+        if (retry) {
+            spoolReplay(spoolId);
+        }
+        else {
+            // Acknowledged or rejected by the connected client, won't be delivered by retrying
+            m_spool.ack(spoolId);
+        }
+    }
+
+    auto inFlightIter = m_inFlight.find(handle);
+    if (inFlightIter != m_inFlight.end()) {
+        if (status == CC_Mqtt5AsyncOpStatus_Complete) {
+            auto latency = std::chrono::duration_cast<std::chrono::microseconds>(m_timeSource->now() - inFlightIter->second);
+            m_metrics.publishAcked(static_cast<std::uint64_t>(latency.count()));
+        }
+
+        m_inFlight.erase(inFlightIter);
+        m_metrics.setInFlightCount(m_inFlight.size());
+        drainSendQueue();
+    }
+
     if (status != CC_Mqtt5AsyncOpStatus_Complete) {
-        reportError(tr("Failed to publish to MQTT5 broker with status: ") + statusStr(status));
+        m_metrics.publishFailedStatus(static_cast<unsigned>(status));
+        reportErrorInternal(tr("Failed to publish to MQTT5 broker with status: ") + statusStr(status));
         return;
     }
 
@@ -1162,7 +2498,8 @@ void Mqtt5ClientFilter::publishCompleteInternal([[maybe_unused]] CC_Mqtt5Publish
     }
 
     if (CC_Mqtt5ReasonCode_UnspecifiedError <= response->m_reasonCode) {
-        reportError(tr("MQTT broker rejected publish with reasonCode=") + QString::number(response->m_reasonCode));
+        m_metrics.publishFailedReason(static_cast<unsigned>(response->m_reasonCode));
+        reportErrorInternal(tr("MQTT broker rejected publish with reasonCode=") + QString::number(response->m_reasonCode));
         return;        
     }    
 }
@@ -1218,6 +2555,11 @@ void Mqtt5ClientFilter::subscribeCompleteCb(void* data, CC_Mqtt5SubscribeHandle
     asThis(data)->subscribeCompleteInternal(handle, status, response);
 }
 
+void Mqtt5ClientFilter::unsubscribeCompleteCb(void* data, CC_Mqtt5UnsubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5UnsubscribeResponse* response)
+{
+    asThis(data)->unsubscribeCompleteInternal(handle, status, response);
+}
+
 void Mqtt5ClientFilter::publishCompleteCb(void* data, CC_Mqtt5PublishHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response)
 {
     asThis(data)->publishCompleteInternal(handle, status, response);
@@ -18,19 +18,44 @@
 
 #pragma once
 
+#include "Mqtt5ClientFilterLogger.h"
+#include "Mqtt5ClientFilterMetrics.h"
+#include "Mqtt5ClientFilterPendingQueue.h"
+#include "Mqtt5ClientFilterRecvBuffer.h"
+#include "Mqtt5ClientFilterSpool.h"
+#include "Mqtt5ClientFilterStrCache.h"
+#include "Mqtt5ClientFilterTimeSource.h"
+#include "Mqtt5ClientFilterTopicAliasTracker.h"
+#include "Mqtt5ClientFilterTopicConfigsList.h"
+#include "Mqtt5ClientFilterWorker.h"
+
 #include <cc_tools_qt/ToolsFilter.h>
 #include <cc_tools_qt/version.h>
 
 #include <cc_mqtt5_client/client.h>
 
 #include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
+#include <QtCore/QVariant>
+#include <QtCore/QVariantMap>
 
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <list>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 static_assert(CC_MQTT5_CLIENT_MAKE_VERSION(1, 0, 6) <= CC_MQTT5_CLIENT_VERSION, "The version of the cc_mqtt5_client library is too old");
 static_assert(CC_TOOLS_QT_MAKE_VERSION(6, 0, 2) <= CC_TOOLS_QT_VERSION, "The version of the cc_tools_qt library is too old");
@@ -43,6 +68,25 @@ class Mqtt5ClientFilter final : public cc_tools_qt::ToolsFilter
     Q_OBJECT
 
 public:
+    // Bits of the configuration change notification
+    enum ConfigChange : unsigned
+    {
+        ConfigChange_ClientId = 1U << 0,
+        ConfigChange_Username = 1U << 1,
+        ConfigChange_Password = 1U << 2,
+        ConfigChange_PubTopic = 1U << 3,
+        ConfigChange_PubQos = 1U << 4,
+        ConfigChange_RespTopic = 1U << 5,
+        ConfigChange_RecvProps = 1U << 6,
+        ConfigChange_UserPropSets = 1U << 7,
+        ConfigChange_Subscribes = 1U << 8,
+        ConfigChange_TopicAliases = 1U << 9,
+        ConfigChange_Misc = 1U << 10, // Fields not having dedicated bit
+        ConfigChange_All = (ConfigChange_Misc << 1U) - 1U
+    };
+
+    using ConfigChanges = unsigned;
+
     struct SubConfig
     {
         QString m_topic;
@@ -52,8 +96,7 @@ public:
         bool m_retainAsPublished = false;
     };
 
-    // erase the element mustn't invalidate references to other elements, using list.
-    using SubConfigsList = std::list<SubConfig>; 
+    using SubConfigsList = Mqtt5ClientFilterTopicConfigsList<SubConfig>; 
 
     struct TopicAliasConfig
     {
@@ -61,8 +104,31 @@ public:
         unsigned m_qos0Rep = 2;
     };
 
-    // erase the element mustn't invalidate references to other elements, using list.
-    using TopicAliasConfigsList = std::list<TopicAliasConfig>; 
+    using TopicAliasConfigsList = Mqtt5ClientFilterTopicConfigsList<TopicAliasConfig>; 
+
+    struct UserPropConfig
+    {
+        QString m_key;
+        QString m_value;
+    };
+
+    using UserPropsList = std::vector<UserPropConfig>;
+
+    // Named sets of the user properties referenced by the outgoing messages.
+    using UserPropSetsMap = std::map<QString, UserPropsList>;
+
+    // Groups of the received message properties which are
+    // expensive to convert into QVariant.
+    enum RecvPropGroup : unsigned
+    {
+        RecvPropGroup_ContentType = 1U << 0,
+        RecvPropGroup_CorrelationData = 1U << 1,
+        RecvPropGroup_ResponseTopic = 1U << 2,
+        RecvPropGroup_SubIds = 1U << 3,
+        RecvPropGroup_UserProps = 1U << 4,
+        RecvPropGroup_FormatExpiry = 1U << 5,
+        RecvPropGroup_All = (1U << 6) - 1U,
+    };
 
     struct Config
     {
@@ -75,28 +141,89 @@ public:
         int m_pubQos = 0;
         SubConfigsList m_subscribes;
         TopicAliasConfigsList m_topicAliases;
+        UserPropSetsMap m_userPropSets;
         unsigned m_keepAlive = 60;
         unsigned m_sessionExpiryInterval = 60;
         unsigned m_topicAliasMaximum = 100;
+        unsigned m_recvBufCapacity = static_cast<unsigned>(Mqtt5ClientFilterRecvBuffer::DefaultCapacity);
+        unsigned m_recvPropGroups = RecvPropGroup_All;
+        unsigned m_metricsDumpPeriod = 0U; // seconds, 0 means disabled
+        unsigned m_sendBatchSize = 0U; // bytes, 0 means no batching
+        unsigned m_sendQueueLimit = 1024U; // publishes waiting for the in-flight window, 0 means unlimited
+        unsigned m_pendingCountLimit = 10000U; // messages waiting for connection, 0 means unlimited
+        unsigned m_pendingBytesLimit = 16U * 1024U * 1024U; // payload bytes waiting for connection, 0 means unlimited
+        unsigned m_pendingDropPolicy = Mqtt5ClientFilterPendingQueue::DropPolicy_Oldest;
+        QString m_spoolFile; // empty means no spooling
+        unsigned m_compressThreshold = 0U; // payload bytes, 0 means no compression
+        int m_compressLevel = -1; // zlib level, -1 means default
+        unsigned m_decompressMaxSize = 16U * 1024U * 1024U; // bytes, 0 means unlimited
+        unsigned m_rpcTimeout = 0U; // ms, 0 means no RPC tracking
+        unsigned m_spoolSegmentSize = static_cast<unsigned>(Mqtt5ClientFilterSpool::DefaultSegmentSize);
         bool m_sessionExpiryInfinite = false;
         bool m_forcedCleanStart = false;
+        bool m_autoTopicAliases = false;
+        bool m_workerThread = false; // run the client engine on the dedicated thread
     };
 
     Mqtt5ClientFilter();
     ~Mqtt5ClientFilter() noexcept;
 
-    Config& config()
+    // The configuration is modified only by the client engine code,
+    // which runs while the owner thread waits for its completion,
+    // so it can be read on the owner thread without synchronization.
+    const Config& config() const
     {
         return m_config;
     }
 
+    // Applies the configuration update in the context of the client engine.
+    template <typename TFunc>
+    void updateConfig(TFunc&& func)
+    {
+        runEngine(
+            [this, &func]()
+            {
+                func(m_config);
+            });
+    }
+
+    // Replaces the source of the time driving the client (keep alive,
+    // response timeouts) as well as the RPC deadlines, send batching and
+    // metrics dump, must be set while the filter is not running.
+    void setTimeSource(Mqtt5ClientFilterTimeSourcePtr source);
+
     void forceCleanStart()
     {
-        m_firstConnect = true;
+        runEngine(
+            [this]()
+            {
+                m_firstConnect = true;
+            });
+    }
+
+    // Must be called after update of the subscribes configuration,
+    // only the difference is sent to the broker on the live connection.
+    void subscribesUpdated();
+
+    // Must be called after update of the publish
+    // configuration (topic, QoS, response topic, user property sets).
+    void publishConfigUpdated()
+    {
+        runEngine(
+            [this]()
+            {
+                m_pubProfile.m_valid = false;
+            });
     }
 
+    QVariantMap metricsSnapshot();
+
+    // Resets the accumulated counters and histograms of the metrics
+    void resetMetrics();
+
 signals:
-    void sigConfigChanged();    
+    // Reported once per event loop iteration with the accumulated ConfigChange bits
+    void sigConfigChanged(unsigned changes);    
 
 protected:
     virtual bool startImpl() override;
@@ -108,7 +235,7 @@ protected:
     virtual const char* debugNameImpl() const override;
 
 private slots:
-    void doTick();
+    void flushConfigChanges();
 
 private:
     struct ClientDeleter
@@ -121,18 +248,157 @@ private:
     
     using ClientPtr = std::unique_ptr<CC_Mqtt5Client, ClientDeleter>;
 
+    static constexpr const char* DebugName = "mqtt v5 client filter";
+    using Clock = std::chrono::steady_clock;
+    using InFlightMap = std::unordered_map<CC_Mqtt5PublishHandle, Clock::time_point>;
+
+    struct QueuedPublish
+    {
+        cc_tools_qt::ToolsDataInfoPtr m_dataPtr;
+        Clock::time_point m_timestamp;
+        int m_qos = 0;
+        Mqtt5ClientFilterSpool::Id m_spoolId = Mqtt5ClientFilterSpool::InvalidId;
+    };
+
+    using SendQueue = std::deque<QueuedPublish>;
+    using SpoolInFlightMap = std::unordered_map<CC_Mqtt5PublishHandle, Mqtt5ClientFilterSpool::Id>;
+
+    // Outstanding RPC requests keyed by the correlation data
+    struct RpcRequest
+    {
+        std::uint64_t m_id = 0U;
+        Clock::time_point m_timestamp;
+    };
+
+    // The timeout is the same for all the requests, the deadlines are
+    // ordered by insertion. Entries of the answered requests are
+    // skipped when expire.
+    struct RpcDeadline
+    {
+        Clock::time_point m_deadline;
+        QByteArray m_key;
+        std::uint64_t m_id = 0U;
+    };
+
+    // Subscriptions known to be active on the broker keyed by the topic
+    using StaticTopicAliasesSet = std::unordered_set<std::string>;
+    using ActiveSubsMap = std::map<std::string, SubConfig>;
+    using SubsInFlightMap = std::unordered_map<CC_Mqtt5SubscribeHandle, std::vector<std::string>>;
+    using UnsubsInFlightMap = std::unordered_map<CC_Mqtt5UnsubscribeHandle, std::vector<ActiveSubsMap::node_type>>;
+
+    using RpcRequestsMap = QHash<QByteArray, RpcRequest>;
+    using RpcDeadlines = std::deque<RpcDeadline>;
+
+    // Reports generated on the worker thread and delivered on the owner one
+    using WorkerReport = std::function<void()>;
+    using WorkerReportsQueue = Mqtt5ClientFilterSpscQueue<WorkerReport>;
+    using WorkerReportsQueuePtr = std::unique_ptr<WorkerReportsQueue>;
+    using WorkerReportsOverflow = std::deque<WorkerReport>;
+    using WorkerPtr = std::unique_ptr<Mqtt5ClientFilterWorker>;
+    static constexpr std::size_t WorkerReportsCapacity = 4096U;
+
+    // Publish configuration pre-converted to the form used by
+    // the client library and the reported properties.
+    // User properties pre-converted to UTF-8
+    using EncodedUserProps = std::vector<std::pair<std::string, std::string>>;
+
+    struct PublishProfile
+    {
+        QHash<QString, EncodedUserProps> m_userPropSets;
+        std::string m_topic;
+        std::string m_respTopic;
+        QVariant m_topicVar;
+        QVariant m_qosVar;
+        int m_qos = 0;
+        bool m_valid = false;
+    };
+
+    template <unsigned TLevel>
+    void debugLog(Mqtt5ClientFilterLogger::Event event, std::uint64_t arg0 = 0U, std::uint64_t arg1 = 0U, const char* str = nullptr)
+    {
+        if constexpr (TLevel <= Mqtt5ClientFilterLogger::MaxLevel) {
+            if (TLevel <= getDebugOutputLevel()) {
+                m_logger.log(event, arg0, arg1, str);
+            }
+        }
+    }
+
+    // Executes the client engine code on the worker thread (when enabled)
+    // and waits for its completion.
+    template <typename TFunc>
+    void runEngine(TFunc&& func)
+    {
+        if ((!m_worker) || (m_worker->isWorkerThread())) {
+            func();
+            return;
+        }
+
+        m_worker->exec(std::forward<TFunc>(func));
+        flushWorkerReports();
+    }
+
+    bool isWorkerThread() const
+    {
+        return m_worker && m_worker->isWorkerThread();
+    }
+
+    void startWorker();
+    void stopWorker();
+    void moveTimersToThread(QThread* thread);
+    void reportErrorInternal(const QString& msg);
+    void reportDataToSendInternal(cc_tools_qt::ToolsDataInfoPtr dataPtr);
+    void reportInterPluginConfigInternal(const QVariantMap& props);
+    void pushWorkerReport(WorkerReport&& report);
+    void deliverWorkerReports();
+    void flushWorkerReports();
+
+    bool doStart();
+    void doStop();
+    QList<cc_tools_qt::ToolsDataInfoPtr> doRecvData(cc_tools_qt::ToolsDataInfoPtr dataPtr);
+    QList<cc_tools_qt::ToolsDataInfoPtr> doSendData(cc_tools_qt::ToolsDataInfoPtr dataPtr);
+    void doSocketConnectionReport(bool connected);
+    void doApplyInterPluginConfig(const QVariantMap& props);
+    void doTick();
     void socketConnected();
     void socketDisconnected();
     void sendPendingData();
     void registerTopicAliases();
+    void reportConfigChanges(ConfigChanges changes);
+    void dumpMetrics();
+    void flushSendBatch();
+    void rpcExpire();
+    QVariantMap metricsSnapshotInternal() const;
+    void resetMetricsInternal();
+    void syncSubscribes();
+    void unsubscribeTopics(const std::vector<std::string>& topics);
+    const PublishProfile& publishProfile();
+    void updateAutoTopicAliases(const std::string& topic);
+    QList<cc_tools_qt::ToolsDataInfoPtr> publishInternal(cc_tools_qt::ToolsDataInfoPtr dataPtr, bool dequeued, Mqtt5ClientFilterSpool::Id spoolId);
+    void reportPublished(cc_tools_qt::ToolsDataInfoPtr dataPtr, bool dequeued, Mqtt5ClientFilterSpool::Id spoolId);
+    std::size_t sendWindow() const;
+    void enqueuePublish(cc_tools_qt::ToolsDataInfoPtr dataPtr, int qos, Mqtt5ClientFilterSpool::Id spoolId);
+    void drainSendQueue();
+    void openSpool();
+    Mqtt5ClientFilterSpool::Id spoolMessage(const cc_tools_qt::ToolsDataInfo& info);
+    void spoolReplay(Mqtt5ClientFilterSpool::Id id);
+    void spoolRelease(Mqtt5ClientFilterSpool::Id id);
+    void releaseAutoTopicAliases();
+    void rpcRegister(const QByteArray& key, std::uint64_t id);
+    void rpcResponse(const CC_Mqtt5MessageInfo& info, QVariantMap& props);
+    void rpcClear();
 
     void sendDataInternal(const unsigned char* buf, unsigned bufLen);
+    void addToSendBatch(const unsigned char* buf, unsigned bufLen);
     void brokerDisconnectedInternal();
+    bool decompressPayload(const CC_Mqtt5MessageInfo& info, cc_tools_qt::ToolsDataInfo& dataInfo);
     void messageReceivedInternal(const CC_Mqtt5MessageInfo& info);
+    std::chrono::microseconds tickElapsed();
+    unsigned tickReportMs(std::chrono::microseconds elapsed, unsigned minMs);
     void nextTickProgramInternal(unsigned ms);
     unsigned cancelTickProgramInternal();
     void connectCompleteInternal(CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5ConnectResponse* response);
     void subscribeCompleteInternal(CC_Mqtt5SubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5SubscribeResponse* response);
+    void unsubscribeCompleteInternal(CC_Mqtt5UnsubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5UnsubscribeResponse* response);
     void publishCompleteInternal(CC_Mqtt5PublishHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response);
     
 
@@ -144,22 +410,56 @@ private:
     static void errorLogCb(void* data, const char* msg);
     static void connectCompleteCb(void* data, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5ConnectResponse* response);
     static void subscribeCompleteCb(void* data, CC_Mqtt5SubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5SubscribeResponse* response);
+    static void unsubscribeCompleteCb(void* data, CC_Mqtt5UnsubscribeHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5UnsubscribeResponse* response);
     static void publishCompleteCb(void* data, CC_Mqtt5PublishHandle handle, CC_Mqtt5AsyncOpStatus status, const CC_Mqtt5PublishResponse* response);
 
     ClientPtr m_client;
-    QTimer m_timer;
-    std::list<cc_tools_qt::ToolsDataInfoPtr> m_pendingData;
-    cc_tools_qt::ToolsDataInfo::DataSeq m_inData;
+    Mqtt5ClientFilterLogger m_logger;
+    Mqtt5ClientFilterTimeSourcePtr m_timeSource;
+    Mqtt5ClientFilterTimerPtr m_tickTimer;
+    Mqtt5ClientFilterTimerPtr m_metricsTimer;
+    Mqtt5ClientFilterTimerPtr m_sendBatchTimer;
+    Mqtt5ClientFilterTimerPtr m_rpcTimer;
+    QTimer m_configChangeTimer;
+    Mqtt5ClientFilterPendingQueue m_pendingData;
+    Mqtt5ClientFilterRecvBuffer m_inData;
     Config m_config;
+    PublishProfile m_pubProfile;
     std::string m_prevClientId;
     unsigned m_tickMs = 0U;
-    qint64 m_tickMeasureTs = 0;
+    Clock::time_point m_tickProgramTs;
+    std::chrono::microseconds m_tickDrift{0}; // elapsed, but not reported to the client yet
     cc_tools_qt::ToolsDataInfoPtr m_recvDataPtr;
+    QVariantMap m_recvBaseProps;
+    Mqtt5ClientFilterStrCache m_recvStrCache;
+    Mqtt5ClientFilterMetrics m_metrics;
+    InFlightMap m_inFlight;
+    SendQueue m_sendQueue;
+    unsigned m_brokerReceiveMax = 0U;
+    Mqtt5ClientFilterSpool m_spool;
+    SpoolInFlightMap m_spoolInFlight;
+    Mqtt5ClientFilterTopicAliasTracker m_autoTopicAliases;
+    StaticTopicAliasesSet m_staticTopicAliases;
+    unsigned m_brokerTopicAliasMax = 0U;
+    ActiveSubsMap m_activeSubs;
+    SubsInFlightMap m_subsInFlight;
+    UnsubsInFlightMap m_unsubsInFlight;
+    RpcRequestsMap m_rpcRequests;
+    RpcDeadlines m_rpcDeadlines;
+    std::chrono::milliseconds m_rpcTimeout{0};
+    std::uint64_t m_rpcNextId = 0U;
     QList<cc_tools_qt::ToolsDataInfoPtr> m_recvData;
     cc_tools_qt::ToolsDataInfoPtr m_sendDataPtr;
     QList<cc_tools_qt::ToolsDataInfoPtr> m_sendData;
+    cc_tools_qt::ToolsDataInfoPtr m_sendBatch;
+    ConfigChanges m_configChanges = 0U;
+    WorkerPtr m_worker;
+    WorkerReportsQueuePtr m_workerReports;
+    WorkerReportsOverflow m_workerReportsOverflow; // accessed by the worker thread only
+    std::atomic<bool> m_workerReportsPending{false};
     bool m_firstConnect = true;
     bool m_socketConnected = false;
+    bool m_batchAll = false;
 };
 
 using Mqtt5ClientFilterPtr = std::shared_ptr<Mqtt5ClientFilter>;
@@ -0,0 +1,384 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterBinCodec.h"
+
+#include <atomic>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+#include <emmintrin.h>
+#endif
+
+// With GCC / Clang the AVX2 code is compiled for the function target
+// and selected at runtime when the CPU supports it.
+#if defined(CC_MQTT5_CLIENT_FILTER_HAS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+#define CC_MQTT5_CLIENT_FILTER_AVX2_TARGET __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(__AVX2__)
+#define CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+#define CC_MQTT5_CLIENT_FILTER_AVX2_TARGET
+#include <immintrin.h>
+#endif
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace 
+{
+
+using DispatchLevel = Mqtt5ClientFilterBinCodec::DispatchLevel;
+
+const char HexChars[] = "0123456789abcdef";
+const QString Base64Prefix("base64:");
+
+int hexValue(char ch)
+{
+    if (('0' <= ch) && (ch <= '9')) {
+        return ch - '0';
+    }
+
+    auto lower = static_cast<char>(ch | 0x20);
+    if (('a' <= lower) && (lower <= 'f')) {
+        return lower - 'a' + 10;
+    }
+
+    return -1;
+}
+
+DispatchLevel detectDispatchLevel()
+{
+#if defined(CC_MQTT5_CLIENT_FILTER_HAS_AVX2) && defined(__AVX2__)
+    return Mqtt5ClientFilterBinCodec::DispatchLevel_Avx2;
+#elif defined(CC_MQTT5_CLIENT_FILTER_HAS_AVX2)
+    if (__builtin_cpu_supports("avx2")) {
+        return Mqtt5ClientFilterBinCodec::DispatchLevel_Avx2;
+    }
+
+    return Mqtt5ClientFilterBinCodec::DispatchLevel_Sse2;
+#elif defined(CC_MQTT5_CLIENT_FILTER_HAS_SSE2)
+    return Mqtt5ClientFilterBinCodec::DispatchLevel_Sse2;
+#else
+    return Mqtt5ClientFilterBinCodec::DispatchLevel_Scalar;
+#endif
+}
+
+std::atomic<int>& currentDispatchLevel()
+{
+    static std::atomic<int> Level(Mqtt5ClientFilterBinCodec::maxDispatchLevel());
+    return Level;
+}
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+
+// Converts 16 hex characters into their nibble values, returns false on invalid character.
+bool hexNibbles16(__m128i chars, __m128i& nibbles)
+{
+    auto lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+    auto isDigit = 
+        _mm_and_si128(
+            _mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), 
+            _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+    auto isAlpha = 
+        _mm_and_si128(
+            _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), 
+            _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+    if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xffff) {
+        return false;
+    }
+
+    nibbles = 
+        _mm_or_si128(
+            _mm_and_si128(isDigit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+            _mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+// Combines pairs of nibbles into 16 bit lanes holding the byte values.
+__m128i hexCombine(__m128i nibbles)
+{
+    auto high = _mm_and_si128(nibbles, _mm_set1_epi16(0x00ff));
+    auto low = _mm_srli_epi16(nibbles, 8);
+    return _mm_or_si128(_mm_slli_epi16(high, 4), low);
+}
+
+__m128i hexChars16(__m128i nibbles)
+{
+    auto letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '0' - 10));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), letters);
+}
+
+// The vectorized loops process the whole blocks and advance
+// the parameters, the tails are left for the next level.
+bool hexDecodeSse2(const char*& str, std::size_t& len, std::uint8_t*& out)
+{
+    while (16U <= len) {
+        __m128i nibbles;
+        if (!hexNibbles16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(str)), nibbles)) {
+            return false;
+        }
+
+        auto bytes = hexCombine(nibbles);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(bytes, bytes));
+
+        str += 16U;
+        len -= 16U;
+        out += 8U;
+    }
+
+    return true;
+}
+
+void hexEncodeSse2(const std::uint8_t*& data, std::size_t& len, char*& out)
+{
+    while (16U <= len) {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+        auto mask = _mm_set1_epi8(0x0f);
+        auto highChars = hexChars16(_mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+        auto lowChars = hexChars16(_mm_and_si128(bytes, mask));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(highChars, lowChars));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16U), _mm_unpackhi_epi8(highChars, lowChars));
+
+        data += 16U;
+        len -= 16U;
+        out += 32U;
+    }
+}
+
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+
+CC_MQTT5_CLIENT_FILTER_AVX2_TARGET
+__m256i hexChars32(__m256i nibbles)
+{
+    auto letters = _mm256_and_si256(_mm256_cmpgt_epi8(nibbles, _mm256_set1_epi8(9)), _mm256_set1_epi8('a' - '0' - 10));
+    return _mm256_add_epi8(_mm256_add_epi8(nibbles, _mm256_set1_epi8('0')), letters);
+}
+
+CC_MQTT5_CLIENT_FILTER_AVX2_TARGET
+bool hexDecodeAvx2(const char*& str, std::size_t& len, std::uint8_t*& out)
+{
+    while (32U <= len) {
+        auto chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(str));
+        auto lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+        auto isDigit = 
+            _mm256_and_si256(
+                _mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)), 
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+        auto isAlpha = 
+            _mm256_and_si256(
+                _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), 
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+
+        if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1) {
+            return false;
+        }
+
+        auto nibbles = 
+            _mm256_or_si256(
+                _mm256_and_si256(isDigit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+                _mm256_and_si256(isAlpha, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+
+        auto high = _mm256_and_si256(nibbles, _mm256_set1_epi16(0x00ff));
+        auto low = _mm256_srli_epi16(nibbles, 8);
+        auto bytes = _mm256_or_si256(_mm256_slli_epi16(high, 4), low);
+        auto packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(bytes, bytes), 0xd8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+
+        str += 32U;
+        len -= 32U;
+        out += 16U;
+    }
+
+    return true;
+}
+
+CC_MQTT5_CLIENT_FILTER_AVX2_TARGET
+void hexEncodeAvx2(const std::uint8_t*& data, std::size_t& len, char*& out)
+{
+    while (32U <= len) {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        auto mask = _mm256_set1_epi8(0x0f);
+        auto highChars = hexChars32(_mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask));
+        auto lowChars = hexChars32(_mm256_and_si256(bytes, mask));
+        auto first = _mm256_unpacklo_epi8(highChars, lowChars);
+        auto second = _mm256_unpackhi_epi8(highChars, lowChars);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute2x128_si256(first, second, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32U), _mm256_permute2x128_si256(first, second, 0x31));
+
+        data += 32U;
+        len -= 32U;
+        out += 64U;
+    }
+}
+
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+
+} // namespace 
+
+Mqtt5ClientFilterBinCodec::DispatchLevel Mqtt5ClientFilterBinCodec::maxDispatchLevel()
+{
+    static const DispatchLevel Level = detectDispatchLevel();
+    return Level;
+}
+
+Mqtt5ClientFilterBinCodec::DispatchLevel Mqtt5ClientFilterBinCodec::dispatchLevel()
+{
+    return static_cast<DispatchLevel>(currentDispatchLevel().load(std::memory_order_relaxed));
+}
+
+void Mqtt5ClientFilterBinCodec::setDispatchLevel(DispatchLevel level)
+{
+    if (maxDispatchLevel() < level) {
+        level = maxDispatchLevel();
+    }
+
+    currentDispatchLevel().store(level, std::memory_order_relaxed);
+}
+
+bool Mqtt5ClientFilterBinCodec::hexDecode(const char* str, std::size_t len, std::uint8_t* out)
+{
+    if ((len & 1U) != 0U) {
+        return false;
+    }
+
+    [[maybe_unused]] auto level = dispatchLevel();
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+    if ((DispatchLevel_Avx2 <= level) && (!hexDecodeAvx2(str, len, out))) {
+        return false;
+    }
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+    if ((DispatchLevel_Sse2 <= level) && (!hexDecodeSse2(str, len, out))) {
+        return false;
+    }
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+
+    return hexDecodeScalar(str, len, out);
+}
+
+bool Mqtt5ClientFilterBinCodec::hexDecodeScalar(const char* str, std::size_t len, std::uint8_t* out)
+{
+    if ((len & 1U) != 0U) {
+        return false;
+    }
+
+    for (auto idx = 0U; idx < len; idx += 2U) {
+        auto high = hexValue(str[idx]);
+        auto low = hexValue(str[idx + 1U]);
+        if ((high < 0) || (low < 0)) {
+            return false;
+        }
+
+        *out = static_cast<std::uint8_t>((high << 4) | low);
+        ++out;
+    }
+
+    return true;
+}
+
+void Mqtt5ClientFilterBinCodec::hexEncode(const std::uint8_t* data, std::size_t len, char* out)
+{
+    [[maybe_unused]] auto level = dispatchLevel();
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+    if (DispatchLevel_Avx2 <= level) {
+        hexEncodeAvx2(data, len, out);
+    }
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_AVX2
+
+#ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+    if (DispatchLevel_Sse2 <= level) {
+        hexEncodeSse2(data, len, out);
+    }
+#endif // #ifdef CC_MQTT5_CLIENT_FILTER_HAS_SSE2
+
+    hexEncodeScalar(data, len, out);
+}
+
+void Mqtt5ClientFilterBinCodec::hexEncodeScalar(const std::uint8_t* data, std::size_t len, char* out)
+{
+    for (auto idx = 0U; idx < len; ++idx) {
+        out[0] = HexChars[data[idx] >> 4];
+        out[1] = HexChars[data[idx] & 0x0f];
+        out += 2U;
+    }
+}
+
+QByteArray Mqtt5ClientFilterBinCodec::fromHex(const QString& str, bool* ok)
+{
+    auto chars = str.toLatin1();
+    QByteArray result(chars.size() / 2, Qt::Uninitialized);
+    bool success = 
+        hexDecode(
+            chars.constData(), 
+            static_cast<std::size_t>(chars.size()), 
+            reinterpret_cast<std::uint8_t*>(result.data()));
+
+    if (ok != nullptr) {
+        *ok = success;
+    }
+
+    if (!success) {
+        return QByteArray();
+    }
+
+    return result;
+}
+
+QString Mqtt5ClientFilterBinCodec::toHex(const std::uint8_t* data, std::size_t len)
+{
+    QByteArray chars(static_cast<int>(len * 2U), Qt::Uninitialized);
+    hexEncode(data, len, chars.data());
+    return QString::fromLatin1(chars);
+}
+
+QByteArray Mqtt5ClientFilterBinCodec::fromBase64(const QString& str, bool* ok)
+{
+    auto decodeResult = QByteArray::fromBase64Encoding(str.toLatin1(), QByteArray::AbortOnBase64DecodingErrors);
+    if (ok != nullptr) {
+        *ok = static_cast<bool>(decodeResult);
+    }
+
+    if (!decodeResult) {
+        return QByteArray();
+    }
+
+    return std::move(decodeResult.decoded);
+}
+
+QString Mqtt5ClientFilterBinCodec::toBase64(const std::uint8_t* data, std::size_t len)
+{
+    return QString::fromLatin1(QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<int>(len)).toBase64());
+}
+
+QByteArray Mqtt5ClientFilterBinCodec::decode(const QString& str, bool* ok)
+{
+    if (str.startsWith(Base64Prefix)) {
+        return fromBase64(str.mid(Base64Prefix.size()), ok);
+    }
+
+    return fromHex(str, ok);
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
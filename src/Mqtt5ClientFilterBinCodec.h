@@ -0,0 +1,72 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Codec of the binary properties (correlation data, password) represented as strings.
+// The hex conversion is vectorized with SSE2 (AVX2 when supported by the CPU),
+// with the scalar fallback for other platforms and the tails.
+class Mqtt5ClientFilterBinCodec
+{
+public:
+    enum DispatchLevel
+    {
+        DispatchLevel_Scalar,
+        DispatchLevel_Sse2,
+        DispatchLevel_Avx2,
+        DispatchLevel_ValuesLimit
+    };
+
+    // The highest level supported by the build and the CPU, used by default
+    static DispatchLevel maxDispatchLevel();
+    static DispatchLevel dispatchLevel();
+
+    // Limits the used vectorization level (capped by the supported one),
+    // allows verifying the lower levels against each other.
+    static void setDispatchLevel(DispatchLevel level);
+
+    // Decodes "len" hex characters into "len / 2" bytes, returns false on
+    // odd length or invalid character.
+    static bool hexDecode(const char* str, std::size_t len, std::uint8_t* out);
+    static bool hexDecodeScalar(const char* str, std::size_t len, std::uint8_t* out);
+
+    // Encodes "len" bytes into "len * 2" lowercase hex characters.
+    static void hexEncode(const std::uint8_t* data, std::size_t len, char* out);
+    static void hexEncodeScalar(const std::uint8_t* data, std::size_t len, char* out);
+
+    static QByteArray fromHex(const QString& str, bool* ok = nullptr);
+    static QString toHex(const std::uint8_t* data, std::size_t len);
+
+    static QByteArray fromBase64(const QString& str, bool* ok = nullptr);
+    static QString toBase64(const std::uint8_t* data, std::size_t len);
+
+    // Decodes binary property string, the "base64:" prefix selects
+    // base64 encoding, hex is assumed otherwise.
+    static QByteArray decode(const QString& str, bool* ok = nullptr);
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -17,12 +17,13 @@
 
 #include "Mqtt5ClientFilterConfigWidget.h"
 
-#include "Mqtt5ClientFilterSubConfigWidget.h"
-#include "Mqtt5ClientFilterTopicAliasWidget.h"
-
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <vector>
 
 #include <QtCore/QtGlobal>
+#include <QtWidgets/QHeaderView>
 
 namespace cc_plugin_mqtt5_client_filter
 {
@@ -30,16 +31,31 @@ namespace cc_plugin_mqtt5_client_filter
 namespace 
 {
 
-void deleteAllWidgetsFrom(QLayout& layout)
+void removeSelectedRows(QTableView& view)
 {
-    while (true) {
-        auto* child = layout.takeAt(0);
-        if (child == nullptr) {
-            break;
+    auto* model = view.model();
+    assert(model != nullptr);
+
+    auto selected = view.selectionModel()->selectedRows();
+    std::vector<int> rows;
+    rows.reserve(static_cast<std::size_t>(selected.size()));
+    for (auto& idx : selected) {
+        rows.push_back(idx.row());
+    }
+
+    // Remove contiguous ranges starting from the end
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    auto iter = rows.begin();
+    while (iter != rows.end()) {
+        auto last = *iter;
+        auto first = last;
+        ++iter;
+        while ((iter != rows.end()) && (*iter == (first - 1))) {
+            first = *iter;
+            ++iter;
         }
 
-        delete child->widget();
-        delete child;
+        model->removeRows(first, last - first + 1);
     }
 }
 
@@ -48,17 +64,19 @@ void deleteAllWidgetsFrom(QLayout& layout)
 
 Mqtt5ClientFilterConfigWidget::Mqtt5ClientFilterConfigWidget(Mqtt5ClientFilter& filter, QWidget* parentObj) :
     Base(parentObj),
-    m_filter(filter)
+    m_filter(filter),
+    m_subsModel(filter),
+    m_topicAliasesModel(filter)
 {
     m_ui.setupUi(this);
 
-    auto subsLayout = new QVBoxLayout;
-    m_ui.m_subsWidget->setLayout(subsLayout);
+    m_ui.m_subsTableView->setModel(&m_subsModel);
+    m_ui.m_subsTableView->horizontalHeader()->setSectionResizeMode(Mqtt5ClientFilterSubsModel::Column_Topic, QHeaderView::Stretch);
+    m_ui.m_subsTableView->horizontalHeader()->setStretchLastSection(false);
 
-    auto topicAliasesLayout = new QVBoxLayout;
-    m_ui.m_topicAliaseWidget->setLayout(topicAliasesLayout);    
+    m_ui.m_topicAliasesTableView->setModel(&m_topicAliasesModel);    
 
-    refresh();
+    refresh(Mqtt5ClientFilter::ConfigChange_All);
 
     connect(
         &m_filter, &Mqtt5ClientFilter::sigConfigChanged,
@@ -68,16 +86,19 @@ Mqtt5ClientFilterConfigWidget::Mqtt5ClientFilterConfigWidget(Mqtt5ClientFilter&
         m_ui.m_respTimeoutSpinBox, qOverload<int>(&QSpinBox::valueChanged),
         this, &Mqtt5ClientFilterConfigWidget::respTimeoutUpdated);    
 
+    // Every configuration update is a round trip to the client engine,
+    // the text is committed when the editing is finished rather than
+    // on every keystroke.
     connect(
-        m_ui.m_clientIdLineEdit, &QLineEdit::textChanged,
+        m_ui.m_clientIdLineEdit, &QLineEdit::editingFinished,
         this, &Mqtt5ClientFilterConfigWidget::clientIdUpdated);
 
     connect(
-        m_ui.m_usernameLineEdit, &QLineEdit::textChanged,
+        m_ui.m_usernameLineEdit, &QLineEdit::editingFinished,
         this, &Mqtt5ClientFilterConfigWidget::usernameUpdated);        
 
     connect(
-        m_ui.m_passwordLineEdit, &QLineEdit::textChanged,
+        m_ui.m_passwordLineEdit, &QLineEdit::editingFinished,
         this, &Mqtt5ClientFilterConfigWidget::passwordUpdated); 
 
     connect(
@@ -106,12 +127,56 @@ Mqtt5ClientFilterConfigWidget::Mqtt5ClientFilterConfigWidget(Mqtt5ClientFilter&
         m_ui.m_topicAliasMaximumSpinBox, qOverload<int>(&QSpinBox::valueChanged),
         this, &Mqtt5ClientFilterConfigWidget::topicAliasMaximumUpdated); 
 
+    connect(
+        m_ui.m_recvBufCapacitySpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::recvBufCapacityUpdated); 
+
+    connect(
+        m_ui.m_sendBatchSizeSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::sendBatchSizeUpdated); 
+
+    connect(
+        m_ui.m_sendQueueLimitSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::sendQueueLimitUpdated); 
+
+    connect(
+        m_ui.m_pendingCountLimitSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::pendingCountLimitUpdated); 
+
+    connect(
+        m_ui.m_pendingBytesLimitSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::pendingBytesLimitUpdated); 
+
+    connect(
+        m_ui.m_pendingDropPolicyComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+        this, &Mqtt5ClientFilterConfigWidget::pendingDropPolicyUpdated); 
+
+    connect(
+        m_ui.m_spoolFileLineEdit, &QLineEdit::editingFinished,
+        this, &Mqtt5ClientFilterConfigWidget::spoolFileUpdated); 
+
+    connect(
+        m_ui.m_compressThresholdSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::compressThresholdUpdated); 
+
+    connect(
+        m_ui.m_rpcTimeoutSpinBox, qOverload<int>(&QSpinBox::valueChanged),
+        this, &Mqtt5ClientFilterConfigWidget::rpcTimeoutUpdated); 
+
+    connect(
+        m_ui.m_workerThreadComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+        this, &Mqtt5ClientFilterConfigWidget::workerThreadUpdated); 
+
+    connect(
+        m_ui.m_autoTopicAliasesComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
+        this, &Mqtt5ClientFilterConfigWidget::autoTopicAliasesUpdated); 
+
     connect(
         m_ui.m_cleanStartComboBox, qOverload<int>(&QComboBox::currentIndexChanged),
         this, &Mqtt5ClientFilterConfigWidget::forcedCleanStartUpdated);           
 
     connect(
-        m_ui.m_pubTopicLineEdit, &QLineEdit::textChanged,
+        m_ui.m_pubTopicLineEdit, &QLineEdit::editingFinished,
         this, &Mqtt5ClientFilterConfigWidget::pubTopicUpdated);        
 
     connect(
@@ -119,7 +184,7 @@ Mqtt5ClientFilterConfigWidget::Mqtt5ClientFilterConfigWidget(Mqtt5ClientFilter&
         this, &Mqtt5ClientFilterConfigWidget::pubQosUpdated);   
 
     connect(
-        m_ui.m_respTopicLineEdit, &QLineEdit::textChanged,
+        m_ui.m_respTopicLineEdit, &QLineEdit::editingFinished,
         this, &Mqtt5ClientFilterConfigWidget::respTopicUpdated);   
 
     connect(
@@ -129,63 +194,98 @@ Mqtt5ClientFilterConfigWidget::Mqtt5ClientFilterConfigWidget(Mqtt5ClientFilter&
     connect(
         m_ui.m_addTopicAliasPushButton, &QPushButton::clicked,
         this, &Mqtt5ClientFilterConfigWidget::addTopicAlias);                     
+
+    connect(
+        m_ui.m_removeSubPushButton, &QPushButton::clicked,
+        this, &Mqtt5ClientFilterConfigWidget::removeSubscribes);           
+
+    connect(
+        m_ui.m_removeTopicAliasPushButton, &QPushButton::clicked,
+        this, &Mqtt5ClientFilterConfigWidget::removeTopicAliases);                     
 }
 
 Mqtt5ClientFilterConfigWidget::~Mqtt5ClientFilterConfigWidget() noexcept = default;
 
-void Mqtt5ClientFilterConfigWidget::refresh()
+void Mqtt5ClientFilterConfigWidget::refresh(unsigned changes)
 {
-    deleteAllWidgetsFrom(*(m_ui.m_subsWidget->layout()));
-    deleteAllWidgetsFrom(*(m_ui.m_topicAliaseWidget->layout()));
+    if ((changes & Mqtt5ClientFilter::ConfigChange_ClientId) != 0U) {
+        m_ui.m_clientIdLineEdit->setText(m_filter.config().m_clientId);
+    }
 
-    for (auto& subConfig : m_filter.config().m_subscribes) {
-        addSubscribeWidget(subConfig);
-    }    
+    if ((changes & Mqtt5ClientFilter::ConfigChange_Username) != 0U) {
+        m_ui.m_usernameLineEdit->setText(m_filter.config().m_username);
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_Password) != 0U) {
+        m_ui.m_passwordLineEdit->setText(m_filter.config().m_password);
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_PubTopic) != 0U) {
+        m_ui.m_pubTopicLineEdit->setText(m_filter.config().m_pubTopic);
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_PubQos) != 0U) {
+        m_ui.m_pubQosSpinBox->setValue(m_filter.config().m_pubQos);
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_RespTopic) != 0U) {
+        m_ui.m_respTopicLineEdit->setText(m_filter.config().m_respTopic);
+    }
 
-    for (auto& aliasConfig : m_filter.config().m_topicAliases) {
-        addTopicAliasWidget(aliasConfig);
+    if ((changes & Mqtt5ClientFilter::ConfigChange_Subscribes) != 0U) {
+        m_subsModel.sync();
+        refreshSubscribes();
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_TopicAliases) != 0U) {
+        m_topicAliasesModel.sync();
+        refreshTopicAliases();
+    }
+
+    if ((changes & Mqtt5ClientFilter::ConfigChange_Misc) == 0U) {
+        return;
     }
 
     m_ui.m_respTimeoutSpinBox->setValue(m_filter.config().m_respTimeout);
-    m_ui.m_clientIdLineEdit->setText(m_filter.config().m_clientId);
-    m_ui.m_usernameLineEdit->setText(m_filter.config().m_username);
-    m_ui.m_passwordLineEdit->setText(m_filter.config().m_password);
     m_ui.m_keepAliveSpinBox->setValue(static_cast<int>(m_filter.config().m_keepAlive));
     m_ui.m_sessionExpiryIntervalSpinBox->setValue(static_cast<int>(m_filter.config().m_sessionExpiryInterval));
     m_ui.m_topicAliasMaximumSpinBox->setValue(static_cast<int>(m_filter.config().m_topicAliasMaximum));
+    m_ui.m_recvBufCapacitySpinBox->setValue(static_cast<int>(m_filter.config().m_recvBufCapacity));
+    m_ui.m_sendBatchSizeSpinBox->setValue(static_cast<int>(m_filter.config().m_sendBatchSize));
+    m_ui.m_sendQueueLimitSpinBox->setValue(static_cast<int>(m_filter.config().m_sendQueueLimit));
+    m_ui.m_pendingCountLimitSpinBox->setValue(static_cast<int>(m_filter.config().m_pendingCountLimit));
+    m_ui.m_pendingBytesLimitSpinBox->setValue(static_cast<int>(m_filter.config().m_pendingBytesLimit));
+    m_ui.m_pendingDropPolicyComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_pendingDropPolicy));
+    m_ui.m_spoolFileLineEdit->setText(m_filter.config().m_spoolFile);
+    m_ui.m_compressThresholdSpinBox->setValue(static_cast<int>(m_filter.config().m_compressThreshold));
+    m_ui.m_rpcTimeoutSpinBox->setValue(static_cast<int>(m_filter.config().m_rpcTimeout));
+    m_ui.m_workerThreadComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_workerThread));
+    m_ui.m_autoTopicAliasesComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_autoTopicAliases));
     m_ui.m_cleanStartComboBox->setCurrentIndex(static_cast<int>(m_filter.config().m_forcedCleanStart));
-    m_ui.m_pubTopicLineEdit->setText(m_filter.config().m_pubTopic);
-    m_ui.m_pubQosSpinBox->setValue(m_filter.config().m_pubQos);
-    m_ui.m_respTopicLineEdit->setText(m_filter.config().m_respTopic);
 
     refreshSessionExpiryInterval();
-    refreshSubscribes();
-    refreshTopicAliases();
 }
 
 void Mqtt5ClientFilterConfigWidget::respTimeoutUpdated(int val)
 {
-    m_filter.config().m_respTimeout = static_cast<unsigned>(val);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_respTimeout, static_cast<unsigned>(val));
 }
 
-void Mqtt5ClientFilterConfigWidget::clientIdUpdated(const QString& val)
+void Mqtt5ClientFilterConfigWidget::clientIdUpdated()
 {
-    if (m_filter.config().m_clientId == val) {
-        return;
+    if (updateConfigField(&Mqtt5ClientFilter::Config::m_clientId, m_ui.m_clientIdLineEdit->text())) {
+        m_filter.forceCleanStart();
     }
-
-    m_filter.config().m_clientId = val;
-    m_filter.forceCleanStart();
 }
 
-void Mqtt5ClientFilterConfigWidget::usernameUpdated(const QString& val)
+void Mqtt5ClientFilterConfigWidget::usernameUpdated()
 {
-    m_filter.config().m_username = val;
+    updateConfigField(&Mqtt5ClientFilter::Config::m_username, m_ui.m_usernameLineEdit->text());
 }
 
-void Mqtt5ClientFilterConfigWidget::passwordUpdated(const QString& val)
+void Mqtt5ClientFilterConfigWidget::passwordUpdated()
 {
-    m_filter.config().m_password = val;
+    updateConfigField(&Mqtt5ClientFilter::Config::m_password, m_ui.m_passwordLineEdit->text());
 }
 
 void Mqtt5ClientFilterConfigWidget::passwordShowHideClicked(bool checked)
@@ -203,12 +303,12 @@ void Mqtt5ClientFilterConfigWidget::passwordShowHideClicked(bool checked)
 
 void Mqtt5ClientFilterConfigWidget::keepAliveUpdated(int val)
 {
-    m_filter.config().m_keepAlive = static_cast<unsigned>(val);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_keepAlive, static_cast<unsigned>(val));
 }
 
 void Mqtt5ClientFilterConfigWidget::sessionExpiryUpdated(int val)
 {
-    m_filter.config().m_sessionExpiryInterval = static_cast<unsigned>(val);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_sessionExpiryInterval, static_cast<unsigned>(val));
 }
 
 void Mqtt5ClientFilterConfigWidget::sessionExpiryInfiniteUpdated(int state)
@@ -218,48 +318,121 @@ void Mqtt5ClientFilterConfigWidget::sessionExpiryInfiniteUpdated(int state)
 
 void Mqtt5ClientFilterConfigWidget::sessionExpiryInfiniteUpdated(Qt::CheckState state)
 {
-    m_filter.config().m_sessionExpiryInfinite = (state != Qt::Unchecked);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_sessionExpiryInfinite, (state != Qt::Unchecked));
     refreshSessionExpiryInterval();
 }
 
 void Mqtt5ClientFilterConfigWidget::topicAliasMaximumUpdated(int val)
 {
-    m_filter.config().m_topicAliasMaximum = static_cast<unsigned>(val);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_topicAliasMaximum, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::recvBufCapacityUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_recvBufCapacity, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::sendBatchSizeUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_sendBatchSize, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::sendQueueLimitUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_sendQueueLimit, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::pendingCountLimitUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_pendingCountLimit, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::pendingBytesLimitUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_pendingBytesLimit, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::pendingDropPolicyUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_pendingDropPolicy, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::spoolFileUpdated()
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_spoolFile, m_ui.m_spoolFileLineEdit->text());
+}
+
+void Mqtt5ClientFilterConfigWidget::compressThresholdUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_compressThreshold, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::rpcTimeoutUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_rpcTimeout, static_cast<unsigned>(val));
+}
+
+void Mqtt5ClientFilterConfigWidget::workerThreadUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_workerThread, (val > 0));
+}
+
+void Mqtt5ClientFilterConfigWidget::autoTopicAliasesUpdated(int val)
+{
+    updateConfigField(&Mqtt5ClientFilter::Config::m_autoTopicAliases, (val > 0));
 }
 
 void Mqtt5ClientFilterConfigWidget::forcedCleanStartUpdated(int val)
 {
-    m_filter.config().m_forcedCleanStart = (val > 0);
+    updateConfigField(&Mqtt5ClientFilter::Config::m_forcedCleanStart, (val > 0));
 }
 
-void Mqtt5ClientFilterConfigWidget::pubTopicUpdated(const QString& val)
+void Mqtt5ClientFilterConfigWidget::pubTopicUpdated()
 {
-    m_filter.config().m_pubTopic = val;
+    if (updateConfigField(&Mqtt5ClientFilter::Config::m_pubTopic, m_ui.m_pubTopicLineEdit->text())) {
+        m_filter.publishConfigUpdated();
+    }
 }
 
 void Mqtt5ClientFilterConfigWidget::pubQosUpdated(int val)
 {
-    m_filter.config().m_pubQos = val;
+    if (updateConfigField(&Mqtt5ClientFilter::Config::m_pubQos, val)) {
+        m_filter.publishConfigUpdated();
+    }
 }
 
-void Mqtt5ClientFilterConfigWidget::respTopicUpdated(const QString& val)
+void Mqtt5ClientFilterConfigWidget::respTopicUpdated()
 {
-    m_filter.config().m_respTopic = val;
+    if (updateConfigField(&Mqtt5ClientFilter::Config::m_respTopic, m_ui.m_respTopicLineEdit->text())) {
+        m_filter.publishConfigUpdated();
+    }
 }
 
 void Mqtt5ClientFilterConfigWidget::addSubscribe()
 {
-    auto& subs = m_filter.config().m_subscribes;
-    subs.resize(subs.size() + 1U);
-    addSubscribeWidget(subs.back());
+    auto idx = m_subsModel.appendConfig();
     refreshSubscribes();
+    m_ui.m_subsTableView->scrollTo(idx);
+    m_ui.m_subsTableView->edit(idx);
 }
 
 void Mqtt5ClientFilterConfigWidget::addTopicAlias()
 {
-    auto& aliases = m_filter.config().m_topicAliases;
-    aliases.resize(aliases.size() + 1U);
-    addTopicAliasWidget(aliases.back());
+    auto idx = m_topicAliasesModel.appendConfig();
+    refreshTopicAliases();
+    m_ui.m_topicAliasesTableView->scrollTo(idx);
+    m_ui.m_topicAliasesTableView->edit(idx);
+}
+
+void Mqtt5ClientFilterConfigWidget::removeSubscribes()
+{
+    removeSelectedRows(*m_ui.m_subsTableView);
+    refreshSubscribes();
+}
+
+void Mqtt5ClientFilterConfigWidget::removeTopicAliases()
+{
+    removeSelectedRows(*m_ui.m_topicAliasesTableView);
     refreshTopicAliases();
 }
 
@@ -272,47 +445,15 @@ void Mqtt5ClientFilterConfigWidget::refreshSessionExpiryInterval()
 void Mqtt5ClientFilterConfigWidget::refreshSubscribes()
 {
     bool subscribesVisible = !m_filter.config().m_subscribes.empty();
-    m_ui.m_subsWidget->setVisible(subscribesVisible);
-}
-
-void Mqtt5ClientFilterConfigWidget::addSubscribeWidget(SubConfig& config)
-{
-    auto* widget = new Mqtt5ClientFilterSubConfigWidget(m_filter, config, this);
-    connect(
-        widget, &QObject::destroyed,
-        this,
-        [this](QObject*)
-        {
-            refreshSubscribes();
-        },
-        Qt::QueuedConnection);
-
-    auto* subsLayout = qobject_cast<QVBoxLayout*>(m_ui.m_subsWidget->layout());
-    assert(subsLayout != nullptr);
-    subsLayout->addWidget(widget); 
+    m_ui.m_subsTableView->setVisible(subscribesVisible);
+    m_ui.m_removeSubPushButton->setVisible(subscribesVisible);
 }
 
 void Mqtt5ClientFilterConfigWidget::refreshTopicAliases()
 {
     bool topicAliasesVisible = !m_filter.config().m_topicAliases.empty();
-    m_ui.m_topicAliaseWidget->setVisible(topicAliasesVisible);
-}
-
-void Mqtt5ClientFilterConfigWidget::addTopicAliasWidget(TopicAliasConfig& config)
-{
-    auto* aliasWidget = new Mqtt5ClientFilterTopicAliasWidget(m_filter, config, this);
-    connect(
-        aliasWidget, &QObject::destroyed,
-        this,
-        [this](QObject*)
-        {
-            refreshTopicAliases();
-        },
-        Qt::QueuedConnection);
-
-    auto* topicAliasesLayout = qobject_cast<QVBoxLayout*>(m_ui.m_topicAliaseWidget->layout());
-    assert(topicAliasesLayout != nullptr);
-    topicAliasesLayout->addWidget(aliasWidget);    
+    m_ui.m_topicAliasesTableView->setVisible(topicAliasesVisible);
+    m_ui.m_removeTopicAliasPushButton->setVisible(topicAliasesVisible);
 }
 
 }  // namespace cc_plugin_mqtt5_client_filter
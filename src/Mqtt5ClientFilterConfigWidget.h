@@ -21,6 +21,8 @@
 #include "ui_Mqtt5ClientFilterConfigWidget.h"
 
 #include "Mqtt5ClientFilter.h"
+#include "Mqtt5ClientFilterSubsModel.h"
+#include "Mqtt5ClientFilterTopicAliasesModel.h"
 
 #include <QtWidgets/QWidget>
 
@@ -38,38 +40,63 @@ public:
     ~Mqtt5ClientFilterConfigWidget() noexcept;
 
 private slots:
-    void refresh();
+    void refresh(unsigned changes);
     void respTimeoutUpdated(int val);
-    void clientIdUpdated(const QString& val);
-    void usernameUpdated(const QString& val);
-    void passwordUpdated(const QString& val);
+    void clientIdUpdated();
+    void usernameUpdated();
+    void passwordUpdated();
     void passwordShowHideClicked(bool checked);
     void keepAliveUpdated(int val);
     void sessionExpiryUpdated(int val);
     void sessionExpiryInfiniteUpdated(int state);
     void sessionExpiryInfiniteUpdated(Qt::CheckState state);
     void topicAliasMaximumUpdated(int val);
+    void recvBufCapacityUpdated(int val);
+    void sendBatchSizeUpdated(int val);
+    void sendQueueLimitUpdated(int val);
+    void pendingCountLimitUpdated(int val);
+    void pendingBytesLimitUpdated(int val);
+    void pendingDropPolicyUpdated(int val);
+    void spoolFileUpdated();
+    void compressThresholdUpdated(int val);
+    void rpcTimeoutUpdated(int val);
+    void workerThreadUpdated(int val);
+    void autoTopicAliasesUpdated(int val);
     void forcedCleanStartUpdated(int val);
-    void pubTopicUpdated(const QString& val);
+    void pubTopicUpdated();
     void pubQosUpdated(int val);
-    void respTopicUpdated(const QString& val);
+    void respTopicUpdated();
     void addSubscribe();
     void addTopicAlias();
+    void removeSubscribes();
+    void removeTopicAliases();
 
 private:
-    using SubConfig = Mqtt5ClientFilter::SubConfig;
-    using TopicAliasConfig = Mqtt5ClientFilter::TopicAliasConfig;
-
     void refreshSessionExpiryInterval();
-
     void refreshSubscribes();
-    void addSubscribeWidget(SubConfig& config);    
-
     void refreshTopicAliases();
-    void addTopicAliasWidget(TopicAliasConfig& config);
+
+    // Returns true when the value is changed
+    template <typename T>
+    bool updateConfigField(T Mqtt5ClientFilter::Config::* field, const T& val)
+    {
+        if ((m_filter.config().*field) == val) {
+            return false;
+        }
+
+        m_filter.updateConfig(
+            [field, &val](Mqtt5ClientFilter::Config& config)
+            {
+                config.*field = val;
+            });
+
+        return true;
+    }
 
     Mqtt5ClientFilter& m_filter;
     Ui::Mqtt5ClientFilterConfigWidget m_ui;
+    Mqtt5ClientFilterSubsModel m_subsModel;
+    Mqtt5ClientFilterTopicAliasesModel m_topicAliasesModel;
 };
 
 }  // namespace cc_plugin_mqtt5_client_filter
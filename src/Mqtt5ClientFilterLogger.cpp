@@ -0,0 +1,234 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterLogger.h"
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+Mqtt5ClientFilterLogger::Mqtt5ClientFilterLogger(const char* name, TimestampFunc&& timestampFunc) :
+    m_name(name),
+    m_timestampFunc(std::move(timestampFunc)),
+    m_records(new Record[Capacity])
+{
+    static_assert((Capacity & (Capacity - 1U)) == 0U, "Capacity must be power of 2");
+    assert(m_timestampFunc);
+}
+
+Mqtt5ClientFilterLogger::~Mqtt5ClientFilterLogger() noexcept
+{
+    if (!m_writer.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_wakeupMutex);
+        m_stopRequested.store(true);
+    }
+
+    m_wakeupCond.notify_one();
+    m_writer.join();
+}
+
+void Mqtt5ClientFilterLogger::log(Event event, std::uint64_t arg0, std::uint64_t arg1, const char* str)
+{
+    auto* record = allocRecord(event);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->m_args[0] = arg0;
+    record->m_args[1] = arg1;
+    record->m_str[0] = '\0';
+    if (str != nullptr) {
+        std::strncpy(record->m_str, str, MaxStrLen);
+        record->m_str[MaxStrLen] = '\0';
+    }
+
+    commitRecord();
+}
+
+void Mqtt5ClientFilterLogger::logText(Event event, const std::string& text)
+{
+    auto* record = allocRecord(event);
+    if (record == nullptr) {
+        return;
+    }
+
+    record->m_text = text;
+    commitRecord();
+}
+
+Mqtt5ClientFilterLogger::Record* Mqtt5ClientFilterLogger::allocRecord(Event event)
+{
+    startWriterIfNeeded();
+
+    auto head = m_head.load(std::memory_order_relaxed);
+    auto tail = m_tail.load(std::memory_order_acquire);
+    if (Capacity <= (head - tail)) {
+        m_dropped.fetch_add(1U, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto& record = m_records[head & (Capacity - 1U)];
+    record.m_timestamp = m_timestampFunc();
+    record.m_event = event;
+    if (!record.m_text.empty()) {
+        record.m_text.clear();
+    }
+
+    return &record;
+}
+
+void Mqtt5ClientFilterLogger::commitRecord()
+{
+    // The sequentially consistent operations on the head and the waiting flag
+    // guarantee that either the writer sees the new record before going to sleep
+    // or the producer sees the writer waiting and wakes it up.
+    m_head.fetch_add(1U);
+    if (!m_writerWaiting.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_wakeupMutex);
+    }
+
+    m_wakeupCond.notify_one();
+}
+
+void Mqtt5ClientFilterLogger::startWriterIfNeeded()
+{
+    std::call_once(
+        m_writerStarted, 
+        [this]()
+        {
+            m_writer = std::thread(&Mqtt5ClientFilterLogger::writerLoop, this);
+        });
+}
+
+void Mqtt5ClientFilterLogger::writerLoop()
+{
+    while (true) {
+        writePending();
+
+        std::unique_lock<std::mutex> lock(m_wakeupMutex);
+        m_writerWaiting.store(true);
+        m_wakeupCond.wait(
+            lock,
+            [this]()
+            {
+                return m_stopRequested.load() || hasPending();
+            });
+        m_writerWaiting.store(false);
+
+        if (m_stopRequested.load()) {
+            break;
+        }
+    }
+
+    writePending();
+}
+
+bool Mqtt5ClientFilterLogger::hasPending() const
+{
+    return m_tail.load(std::memory_order_relaxed) != m_head.load();
+}
+
+void Mqtt5ClientFilterLogger::writePending()
+{
+    auto tail = m_tail.load(std::memory_order_relaxed);
+    auto head = m_head.load(std::memory_order_acquire);
+    if (tail == head) {
+        return;
+    }
+
+    for (; tail != head; ++tail) {
+        format(std::cout, m_records[tail & (Capacity - 1U)]);
+        m_tail.store(tail + 1U, std::memory_order_release);
+    }
+
+    auto dropped = m_dropped.exchange(0U, std::memory_order_relaxed);
+    if (dropped > 0U) {
+        std::cout << '(' << m_name << "): " << dropped << " debug records were dropped\n";
+    }
+
+    std::cout.flush();
+}
+
+void Mqtt5ClientFilterLogger::format(std::ostream& out, const Record& record) const
+{
+    out << '[' << record.m_timestamp << "] (" << m_name << "): ";
+    switch (record.m_event) {
+        case Event_ConsumedBytes:
+            out << "consumed bytes: " << record.m_args[0] << "/" << record.m_args[1];
+            break;
+        case Event_Publish:
+            out << "publish: " << record.m_str;
+            break;
+        case Event_RecvStrCacheHits:
+            out << "received strings cache hits: " << record.m_args[0] << "/" << record.m_args[1];
+            if (record.m_args[1] > 0U) {
+                out << " (" << ((static_cast<double>(record.m_args[0]) * 100.0) / static_cast<double>(record.m_args[1])) << "%)";
+            }
+            break;
+        case Event_SocketConnected:
+            out << "socket connected report";
+            break;
+        case Event_SocketDisconnected:
+            out << "socket disconnected report";
+            break;
+        case Event_Sending:
+            out << "sending " << record.m_args[0] << " bytes";
+            break;
+        case Event_MessageReceived:
+            out << "app message received: " << record.m_str;
+            break;
+        case Event_TickRequest:
+            out << "tick request: " << record.m_args[0];
+            break;
+        case Event_TickCancel:
+            out << "cancel tick: " << record.m_args[0];
+            break;
+        case Event_TopicAliasAlloc:
+            out << "automatic topic alias allocated: " << record.m_str;
+            break;
+        case Event_TopicAliasFree:
+            out << "automatic topic alias released: " << record.m_str;
+            break;
+        case Event_TopicAliasBytesSaved:
+            out << "automatic topic aliases saved " << record.m_args[0] << " bytes";
+            break;
+        case Event_Metrics:
+            out << "metrics: " << record.m_text;
+            break;
+        default:
+            assert(false); // Should not happen
+            out << "unknown event " << static_cast<unsigned>(record.m_event);
+            break;
+    }
+
+    out << '\n';
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,121 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#ifndef CC_MQTT5_CLIENT_FILTER_DEBUG_LOG_MAX_LEVEL
+#define CC_MQTT5_CLIENT_FILTER_DEBUG_LOG_MAX_LEVEL 3
+#endif
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Asynchronous debug output. The records are stored in binary form in the lock-free
+// single producer / single consumer ring and are formatted and written
+// to the standard output by the background thread, which sleeps while
+// there is nothing to write.
+class Mqtt5ClientFilterLogger
+{
+public:
+    // Debug levels above this value are compiled out.
+    static constexpr unsigned MaxLevel = CC_MQTT5_CLIENT_FILTER_DEBUG_LOG_MAX_LEVEL;
+
+    enum Event : unsigned
+    {
+        Event_ConsumedBytes, // arg0 - consumed, arg1 - total
+        Event_Publish, // str - topic
+        Event_RecvStrCacheHits, // arg0 - hits, arg1 - total
+        Event_SocketConnected,
+        Event_SocketDisconnected,
+        Event_Sending, // arg0 - bytes
+        Event_MessageReceived, // str - topic
+        Event_TickRequest, // arg0 - ms
+        Event_TickCancel, // arg0 - ms
+        Event_TopicAliasAlloc, // str - topic
+        Event_TopicAliasFree, // str - topic
+        Event_TopicAliasBytesSaved, // arg0 - bytes
+        Event_Metrics, // text - metrics JSON
+        Event_ValuesLimit
+    };
+
+    // Provides the timestamp of the record, taken when the record is logged
+    using TimestampFunc = std::function<std::uint64_t ()>;
+
+    Mqtt5ClientFilterLogger(const char* name, TimestampFunc&& timestampFunc);
+    ~Mqtt5ClientFilterLogger() noexcept;
+
+    void log(Event event, std::uint64_t arg0 = 0U, std::uint64_t arg1 = 0U, const char* str = nullptr);
+
+    // Logs the text not fitting into the fixed size record, not meant for the frequent output.
+    void logText(Event event, const std::string& text);
+
+    std::uint64_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr std::size_t Capacity = 4096U; // must be power of 2
+    static constexpr std::size_t MaxStrLen = 127U;
+
+    struct Record
+    {
+        std::uint64_t m_timestamp = 0U;
+        Event m_event = Event_ValuesLimit;
+        std::uint64_t m_args[2] = {};
+        char m_str[MaxStrLen + 1U] = {};
+        std::string m_text;
+    };
+
+    Record* allocRecord(Event event);
+    void commitRecord();
+    void startWriterIfNeeded();
+    void writerLoop();
+    bool hasPending() const;
+    void writePending();
+    void format(std::ostream& out, const Record& record) const;
+
+    const char* m_name = nullptr;
+    TimestampFunc m_timestampFunc;
+    std::unique_ptr<Record[]> m_records;
+    std::atomic<std::size_t> m_head{0U}; // written by the producer
+    std::atomic<std::size_t> m_tail{0U}; // written by the writer thread
+    std::atomic<std::uint64_t> m_dropped{0U};
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<bool> m_writerWaiting{false};
+    std::mutex m_wakeupMutex;
+    std::condition_variable m_wakeupCond;
+    std::once_flag m_writerStarted;
+    std::thread m_writer;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+
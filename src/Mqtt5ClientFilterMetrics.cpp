@@ -0,0 +1,312 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterMetrics.h"
+
+#include <QtCore/QString>
+#include <QtCore/QVariantList>
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace 
+{
+
+template <typename TArr>
+void resetAll(TArr& counters)
+{
+    for (auto& c : counters) {
+        c.store(0U, std::memory_order_relaxed);
+    }
+}
+
+} // namespace 
+
+Mqtt5ClientFilterMetrics::Histogram::Histogram(std::initializer_list<std::uint64_t> bounds)
+{
+    assert(bounds.size() <= MaxBounds);
+    m_boundsCount = std::min(bounds.size(), MaxBounds);
+    std::copy_n(bounds.begin(), m_boundsCount, m_bounds.begin());
+    resetAll(m_counts);
+}
+
+void Mqtt5ClientFilterMetrics::Histogram::add(std::uint64_t value)
+{
+    auto boundsEnd = m_bounds.begin() + static_cast<std::ptrdiff_t>(m_boundsCount);
+    auto idx = static_cast<std::size_t>(std::distance(m_bounds.begin(), std::lower_bound(m_bounds.begin(), boundsEnd, value)));
+    m_counts[idx].fetch_add(1U, std::memory_order_relaxed);
+    m_total.fetch_add(1U, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    auto prevMax = m_max.load(std::memory_order_relaxed);
+    while ((prevMax < value) && (!m_max.compare_exchange_weak(prevMax, value, std::memory_order_relaxed))) {}
+}
+
+QVariantMap Mqtt5ClientFilterMetrics::Histogram::snapshot() const
+{
+    QVariantList buckets;
+    for (auto idx = 0U; idx <= m_boundsCount; ++idx) {
+        QVariantMap bucket;
+        if (idx < m_boundsCount) {
+            bucket["le"] = static_cast<qulonglong>(m_bounds[idx]);
+        }
+        else {
+            bucket["le"] = QString("inf");
+        }
+
+        bucket["count"] = static_cast<qulonglong>(m_counts[idx].load(std::memory_order_relaxed));
+        buckets.append(bucket);
+    }
+
+    QVariantMap result;
+    result["buckets"] = buckets;
+    result["count"] = static_cast<qulonglong>(m_total.load(std::memory_order_relaxed));
+    result["sum"] = static_cast<qulonglong>(m_sum.load(std::memory_order_relaxed));
+    result["max"] = static_cast<qulonglong>(m_max.load(std::memory_order_relaxed));
+    return result;
+}
+
+void Mqtt5ClientFilterMetrics::Histogram::reset()
+{
+    resetAll(m_counts);
+    m_total.store(0U, std::memory_order_relaxed);
+    m_sum.store(0U, std::memory_order_relaxed);
+    m_max.store(0U, std::memory_order_relaxed);
+}
+
+Mqtt5ClientFilterMetrics::Mqtt5ClientFilterMetrics() :
+    m_pubAckLatencyUs({100U, 250U, 500U, 1000U, 2500U, 5000U, 10000U, 25000U, 50000U, 100000U, 250000U, 500000U, 1000000U}),
+    m_tickLateUs({50U, 100U, 250U, 500U, 1000U, 2500U, 5000U, 10000U, 25000U, 50000U, 100000U, 250000U, 1000000U}),
+    m_sendQueueWaitUs({100U, 250U, 500U, 1000U, 2500U, 5000U, 10000U, 25000U, 50000U, 100000U, 250000U, 500000U, 1000000U}),
+    m_rpcLatencyUs({1000U, 2500U, 5000U, 10000U, 25000U, 50000U, 100000U, 250000U, 500000U, 1000000U, 2500000U, 5000000U, 10000000U})
+{
+    reset();
+}
+
+void Mqtt5ClientFilterMetrics::messageSent(unsigned qos, std::size_t bytes, std::size_t wireBytes)
+{
+    auto idx = std::min(static_cast<std::size_t>(qos), QosCount - 1U);
+    inc(m_msgsOut[idx]);
+    inc(m_bytesOut[idx], bytes);
+    inc(m_wireBytesOut[idx], wireBytes);
+}
+
+void Mqtt5ClientFilterMetrics::messageReceived(unsigned qos, std::size_t bytes, std::size_t wireBytes)
+{
+    auto idx = std::min(static_cast<std::size_t>(qos), QosCount - 1U);
+    inc(m_msgsIn[idx]);
+    inc(m_bytesIn[idx], bytes);
+    inc(m_wireBytesIn[idx], wireBytes);
+}
+
+void Mqtt5ClientFilterMetrics::publishFailedStatus(unsigned status)
+{
+    inc(m_pubFailedStatus[std::min(static_cast<std::size_t>(status), MaxStatus - 1U)]);
+}
+
+void Mqtt5ClientFilterMetrics::publishFailedReason(unsigned reasonCode)
+{
+    inc(m_pubFailedReason[std::min(static_cast<std::size_t>(reasonCode), MaxReasonCode - 1U)]);
+}
+
+void Mqtt5ClientFilterMetrics::publishAcked(std::uint64_t latencyUs)
+{
+    m_pubAckLatencyUs.add(latencyUs);
+}
+
+void Mqtt5ClientFilterMetrics::tickFired(std::int64_t lateUs, std::int64_t driftUs)
+{
+    if (lateUs < 0) {
+        inc(m_tickEarly);
+        lateUs = 0;
+    }
+
+    m_tickLateUs.add(static_cast<std::uint64_t>(lateUs));
+    m_tickDriftUs.store(driftUs, std::memory_order_relaxed);
+}
+
+void Mqtt5ClientFilterMetrics::setPendingCount(std::size_t value)
+{
+    set(m_pendingCount, value);
+}
+
+void Mqtt5ClientFilterMetrics::setInFlightCount(std::size_t value)
+{
+    set(m_inFlightCount, value);
+}
+
+void Mqtt5ClientFilterMetrics::setRecvHighWaterMark(std::size_t value)
+{
+    set(m_recvHighWaterMark, value);
+}
+
+void Mqtt5ClientFilterMetrics::setSendQueueDepth(std::size_t value)
+{
+    set(m_sendQueueDepth, value);
+}
+
+void Mqtt5ClientFilterMetrics::sendQueueWaited(std::uint64_t waitUs)
+{
+    m_sendQueueWaitUs.add(waitUs);
+}
+
+void Mqtt5ClientFilterMetrics::sendQueueDropped()
+{
+    inc(m_sendQueueDropped);
+}
+
+void Mqtt5ClientFilterMetrics::messageCompressed(std::size_t origBytes, std::size_t compressedBytes)
+{
+    inc(m_compressedMsgs);
+    inc(m_compressInBytes, origBytes);
+    inc(m_compressOutBytes, compressedBytes);
+}
+
+void Mqtt5ClientFilterMetrics::messageDecompressed(std::size_t compressedBytes, std::size_t origBytes)
+{
+    inc(m_decompressedMsgs);
+    inc(m_decompressInBytes, compressedBytes);
+    inc(m_decompressOutBytes, origBytes);
+}
+
+void Mqtt5ClientFilterMetrics::rpcRequested()
+{
+    inc(m_rpcRequests);
+}
+
+void Mqtt5ClientFilterMetrics::rpcResponded(std::uint64_t latencyUs)
+{
+    inc(m_rpcResponses);
+    m_rpcLatencyUs.add(latencyUs);
+}
+
+void Mqtt5ClientFilterMetrics::rpcTimedOut()
+{
+    inc(m_rpcTimeouts);
+}
+
+void Mqtt5ClientFilterMetrics::metricsDumped()
+{
+    inc(m_metricsDumps);
+}
+
+QVariantMap Mqtt5ClientFilterMetrics::snapshot() const
+{
+    QVariantMap failedStatus;
+    for (auto idx = 0U; idx < m_pubFailedStatus.size(); ++idx) {
+        auto val = get(m_pubFailedStatus[idx]);
+        if (val != 0U) {
+            failedStatus[QString::number(idx)] = static_cast<qulonglong>(val);
+        }
+    }
+
+    QVariantMap failedReason;
+    for (auto idx = 0U; idx < m_pubFailedReason.size(); ++idx) {
+        auto val = get(m_pubFailedReason[idx]);
+        if (val != 0U) {
+            failedReason[QString::number(idx)] = static_cast<qulonglong>(val);
+        }
+    }
+
+    QVariantMap result;
+    result["msgs_out"] = toVariantList(m_msgsOut);
+    result["bytes_out"] = toVariantList(m_bytesOut);
+    result["wire_bytes_out"] = toVariantList(m_wireBytesOut);
+    result["msgs_in"] = toVariantList(m_msgsIn);
+    result["bytes_in"] = toVariantList(m_bytesIn);
+    result["wire_bytes_in"] = toVariantList(m_wireBytesIn);
+    result["pub_failed_status"] = failedStatus;
+    result["pub_failed_reason"] = failedReason;
+    result["pending"] = static_cast<qulonglong>(get(m_pendingCount));
+    result["in_flight"] = static_cast<qulonglong>(get(m_inFlightCount));
+    result["recv_buf_high_water_mark"] = static_cast<qulonglong>(get(m_recvHighWaterMark));
+    result["pub_ack_latency_us"] = m_pubAckLatencyUs.snapshot();
+    result["tick_late_us"] = m_tickLateUs.snapshot();
+    result["tick_early"] = static_cast<qulonglong>(get(m_tickEarly));
+    result["tick_drift_us"] = static_cast<qlonglong>(m_tickDriftUs.load(std::memory_order_relaxed));
+    result["send_queue_depth"] = static_cast<qulonglong>(get(m_sendQueueDepth));
+    result["send_queue_dropped"] = static_cast<qulonglong>(get(m_sendQueueDropped));
+    result["send_queue_wait_us"] = m_sendQueueWaitUs.snapshot();
+    result["compressed_msgs"] = static_cast<qulonglong>(get(m_compressedMsgs));
+    result["compress_in_bytes"] = static_cast<qulonglong>(get(m_compressInBytes));
+    result["compress_out_bytes"] = static_cast<qulonglong>(get(m_compressOutBytes));
+    result["compress_ratio"] = ratio(m_compressInBytes, m_compressOutBytes);
+    result["decompressed_msgs"] = static_cast<qulonglong>(get(m_decompressedMsgs));
+    result["decompress_in_bytes"] = static_cast<qulonglong>(get(m_decompressInBytes));
+    result["decompress_out_bytes"] = static_cast<qulonglong>(get(m_decompressOutBytes));
+    result["decompress_ratio"] = ratio(m_decompressOutBytes, m_decompressInBytes);
+    result["rpc_requests"] = static_cast<qulonglong>(get(m_rpcRequests));
+    result["rpc_responses"] = static_cast<qulonglong>(get(m_rpcResponses));
+    result["rpc_timeouts"] = static_cast<qulonglong>(get(m_rpcTimeouts));
+    result["rpc_latency_us"] = m_rpcLatencyUs.snapshot();
+    result["metrics_dumps"] = static_cast<qulonglong>(get(m_metricsDumps));
+    return result;
+}
+
+void Mqtt5ClientFilterMetrics::reset()
+{
+    resetAll(m_msgsOut);
+    resetAll(m_bytesOut);
+    resetAll(m_wireBytesOut);
+    resetAll(m_msgsIn);
+    resetAll(m_bytesIn);
+    resetAll(m_wireBytesIn);
+    resetAll(m_pubFailedStatus);
+    resetAll(m_pubFailedReason);
+    m_pubAckLatencyUs.reset();
+    m_tickLateUs.reset();
+    m_tickEarly.store(0U, std::memory_order_relaxed);
+    m_tickDriftUs.store(0, std::memory_order_relaxed);
+    m_sendQueueDropped.store(0U, std::memory_order_relaxed);
+    m_compressedMsgs.store(0U, std::memory_order_relaxed);
+    m_compressInBytes.store(0U, std::memory_order_relaxed);
+    m_compressOutBytes.store(0U, std::memory_order_relaxed);
+    m_decompressedMsgs.store(0U, std::memory_order_relaxed);
+    m_decompressInBytes.store(0U, std::memory_order_relaxed);
+    m_decompressOutBytes.store(0U, std::memory_order_relaxed);
+    m_sendQueueWaitUs.reset();
+    m_rpcLatencyUs.reset();
+    m_rpcRequests.store(0U, std::memory_order_relaxed);
+    m_rpcResponses.store(0U, std::memory_order_relaxed);
+    m_rpcTimeouts.store(0U, std::memory_order_relaxed);
+    m_metricsDumps.store(0U, std::memory_order_relaxed);
+}
+
+double Mqtt5ClientFilterMetrics::ratio(const Counter& numerator, const Counter& denominator)
+{
+    auto denominatorVal = get(denominator);
+    if (denominatorVal == 0U) {
+        return 0.0;
+    }
+
+    return static_cast<double>(get(numerator)) / static_cast<double>(denominatorVal);
+}
+
+QVariantList Mqtt5ClientFilterMetrics::toVariantList(const QosCounters& counters)
+{
+    QVariantList result;
+    for (auto& c : counters) {
+        result.append(static_cast<qulonglong>(get(c)));
+    }
+    return result;
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,147 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QVariantMap>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Low overhead runtime metrics of the filter. All the counters are relaxed atomics,
+// the snapshot can be taken at any time.
+class Mqtt5ClientFilterMetrics
+{
+public:
+    static constexpr std::size_t QosCount = 3U;
+
+    // Histogram with fixed upper bounds of the buckets, the last bucket is unbounded.
+    class Histogram
+    {
+    public:
+        static constexpr std::size_t MaxBounds = 16U;
+
+        explicit Histogram(std::initializer_list<std::uint64_t> bounds);
+
+        void add(std::uint64_t value);
+        QVariantMap snapshot() const;
+        void reset();
+
+    private:
+        std::array<std::uint64_t, MaxBounds> m_bounds = {};
+        std::size_t m_boundsCount = 0U;
+        std::array<std::atomic<std::uint64_t>, MaxBounds + 1U> m_counts;
+        std::atomic<std::uint64_t> m_total{0U};
+        std::atomic<std::uint64_t> m_sum{0U};
+        std::atomic<std::uint64_t> m_max{0U};
+    };
+
+    Mqtt5ClientFilterMetrics();
+
+    // The bytes are the payload size as seen by the user, the wire 
+    // bytes are the ones carried by the PUBLISH (compressed when applicable).
+    void messageSent(unsigned qos, std::size_t bytes, std::size_t wireBytes);
+    void messageReceived(unsigned qos, std::size_t bytes, std::size_t wireBytes);
+    void publishFailedStatus(unsigned status);
+    void publishFailedReason(unsigned reasonCode);
+    void publishAcked(std::uint64_t latencyUs);
+    void tickFired(std::int64_t lateUs, std::int64_t driftUs);
+    void setPendingCount(std::size_t value);
+    void setInFlightCount(std::size_t value);
+    void setRecvHighWaterMark(std::size_t value);
+    void setSendQueueDepth(std::size_t value);
+    void sendQueueWaited(std::uint64_t waitUs);
+    void sendQueueDropped();
+    void messageCompressed(std::size_t origBytes, std::size_t compressedBytes);
+    void messageDecompressed(std::size_t compressedBytes, std::size_t origBytes);
+    void rpcRequested();
+    void rpcResponded(std::uint64_t latencyUs);
+    void rpcTimedOut();
+    void metricsDumped();
+
+    QVariantMap snapshot() const;
+
+    // Resets the counters and histograms, the gauges reflecting the
+    // current state (pending, in flight, etc...) are kept.
+    void reset();
+
+private:
+    using Counter = std::atomic<std::uint64_t>;
+    using QosCounters = std::array<Counter, QosCount>;
+
+    static constexpr std::size_t MaxStatus = 16U;
+    static constexpr std::size_t MaxReasonCode = 256U;
+
+    static void inc(Counter& counter, std::uint64_t val = 1U)
+    {
+        counter.fetch_add(val, std::memory_order_relaxed);
+    }
+
+    static void set(Counter& counter, std::uint64_t val)
+    {
+        counter.store(val, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t get(const Counter& counter)
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+    static QVariantList toVariantList(const QosCounters& counters);
+    static double ratio(const Counter& numerator, const Counter& denominator);
+
+    QosCounters m_msgsOut;
+    QosCounters m_bytesOut;
+    QosCounters m_wireBytesOut;
+    QosCounters m_msgsIn;
+    QosCounters m_bytesIn;
+    QosCounters m_wireBytesIn;
+    std::array<Counter, MaxStatus> m_pubFailedStatus;
+    std::array<Counter, MaxReasonCode> m_pubFailedReason;
+    Counter m_pendingCount{0U};
+    Counter m_inFlightCount{0U};
+    Counter m_recvHighWaterMark{0U};
+    Counter m_sendQueueDepth{0U};
+    Counter m_sendQueueDropped{0U};
+    Counter m_compressedMsgs{0U};
+    Counter m_compressInBytes{0U};
+    Counter m_compressOutBytes{0U};
+    Counter m_decompressedMsgs{0U};
+    Counter m_decompressInBytes{0U};
+    Counter m_decompressOutBytes{0U};
+    Counter m_rpcRequests{0U};
+    Counter m_rpcResponses{0U};
+    Counter m_rpcTimeouts{0U};
+    Counter m_metricsDumps{0U};
+    Counter m_tickEarly{0U};
+    std::atomic<std::int64_t> m_tickDriftUs{0};
+    Histogram m_pubAckLatencyUs;
+    Histogram m_tickLateUs;
+    Histogram m_sendQueueWaitUs;
+    Histogram m_rpcLatencyUs;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+
@@ -0,0 +1,184 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterPendingQueue.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+bool Mqtt5ClientFilterPendingQueue::push(cc_tools_qt::ToolsDataInfoPtr dataPtr, int qos, SpoolId spoolId)
+{
+    assert(dataPtr);
+    auto bytes = dataPtr->m_data.size();
+    while (exceedsLimits(bytes)) {
+        bool dropNew = 
+            (m_live == 0U) || 
+            (m_policy == DropPolicy_Newest) ||
+            ((m_policy == DropPolicy_Qos0First) && (qos == 0) && (m_qos0Count == 0U));
+
+        if (dropNew) {
+            if (m_dropHandler) {
+                m_dropHandler(*dataPtr, spoolId);
+            }
+
+            ++m_dropped;
+            m_droppedBytes += bytes;
+            return false;
+        }
+
+        if ((m_policy == DropPolicy_Qos0First) && dropOldestQos0()) {
+            continue;
+        }
+
+        dropFront();
+    }
+
+    if (m_used == m_ring.size()) {
+        reallocate();
+    }
+
+    auto& elem = slot(m_used);
+    elem.m_dataPtr = std::move(dataPtr);
+    elem.m_bytes = bytes;
+    elem.m_spoolId = spoolId;
+    elem.m_qos = qos;
+    ++m_used;
+    ++m_live;
+    m_bytes += bytes;
+    if (qos == 0) {
+        ++m_qos0Count;
+    }
+
+    return true;
+}
+
+void Mqtt5ClientFilterPendingQueue::clear()
+{
+    m_ring.clear();
+    resetState();
+}
+
+bool Mqtt5ClientFilterPendingQueue::exceedsLimits(std::size_t bytes) const
+{
+    return 
+        ((m_countLimit > 0U) && (m_countLimit <= m_live)) ||
+        ((m_bytesLimit > 0U) && (m_bytesLimit < (m_bytes + bytes)));
+}
+
+void Mqtt5ClientFilterPendingQueue::dropFront()
+{
+    assert(0U < m_live);
+    trimFront();
+    dropAt(0U);
+    trimFront();
+}
+
+bool Mqtt5ClientFilterPendingQueue::dropOldestQos0()
+{
+    if (m_qos0Count == 0U) {
+        return false;
+    }
+
+    for (auto idx = m_qos0Cursor; idx < m_used; ++idx) {
+        auto& elem = slot(idx);
+        if ((!elem.m_dataPtr) || (elem.m_qos != 0)) {
+            continue;
+        }
+
+        dropAt(idx);
+        m_qos0Cursor = idx + 1U;
+        trimFront();
+        return true;
+    }
+
+    assert(false); // Should not happen
+    return false;
+}
+
+void Mqtt5ClientFilterPendingQueue::dropAt(std::size_t idx)
+{
+    auto& elem = slot(idx);
+    assert(elem.m_dataPtr);
+    if (m_dropHandler) {
+        m_dropHandler(*elem.m_dataPtr, elem.m_spoolId);
+    }
+
+    elem.m_dataPtr.reset();
+    ++m_dropped;
+    m_droppedBytes += elem.m_bytes;
+    m_bytes -= elem.m_bytes;
+    --m_live;
+    if (elem.m_qos == 0) {
+        --m_qos0Count;
+    }
+}
+
+void Mqtt5ClientFilterPendingQueue::trimFront()
+{
+    while ((0U < m_used) && (!slot(0U).m_dataPtr)) {
+        m_head = (m_head + 1U) & (m_ring.size() - 1U);
+        --m_used;
+        if (0U < m_qos0Cursor) {
+            --m_qos0Cursor;
+        }
+    }
+
+    if (m_used == 0U) {
+        m_head = 0U;
+        m_qos0Cursor = 0U;
+    }
+}
+
+void Mqtt5ClientFilterPendingQueue::reallocate()
+{
+    // Grow only when there are no dropped slots to reclaim
+    auto newCapacity = m_ring.size();
+    if (m_live == m_ring.size()) {
+        newCapacity = std::max(m_ring.size() * 2U, MinCapacity);
+    }
+
+    std::vector<Elem> ring(newCapacity);
+    std::size_t count = 0U;
+    for (auto idx = 0U; idx < m_used; ++idx) {
+        auto& elem = slot(idx);
+        if (elem.m_dataPtr) {
+            ring[count] = std::move(elem);
+            ++count;
+        }
+    }
+
+    assert(count == m_live);
+    m_ring = std::move(ring);
+    m_head = 0U;
+    m_used = count;
+    m_qos0Cursor = 0U;
+}
+
+void Mqtt5ClientFilterPendingQueue::resetState()
+{
+    m_head = 0U;
+    m_used = 0U;
+    m_live = 0U;
+    m_bytes = 0U;
+    m_qos0Count = 0U;
+    m_qos0Cursor = 0U;
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,170 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cc_tools_qt/ToolsDataInfo.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Bounded queue of the messages waiting for the MQTT session to be established.
+// The elements are stored in the contiguous ring which grows on demand. The
+// limits are applied to the number of messages and total payload bytes, the
+// overflow is resolved according to the drop policy. The elements dropped
+// from the middle of the queue (QoS0 first policy) are left as empty slots
+// which are skipped and reclaimed on the next growth.
+class Mqtt5ClientFilterPendingQueue
+{
+public:
+    enum DropPolicy : unsigned
+    {
+        DropPolicy_Oldest,
+        DropPolicy_Newest,
+        DropPolicy_Qos0First,
+        DropPolicy_ValuesLimit
+    };
+
+    // Id of the spool record travelling with the queued message, 0 when not spooled
+    using SpoolId = std::uint64_t;
+    using DropHandler = std::function<void (const cc_tools_qt::ToolsDataInfo& info, SpoolId spoolId)>;
+
+    void setLimits(std::size_t countLimit, std::size_t bytesLimit)
+    {
+        m_countLimit = countLimit;
+        m_bytesLimit = bytesLimit;
+    }
+
+    void setDropPolicy(DropPolicy value)
+    {
+        m_policy = value;
+    }
+
+    template <typename TFunc>
+    void setDropHandler(TFunc&& func)
+    {
+        m_dropHandler = std::forward<TFunc>(func);
+    }
+
+    // Returns false if the pushed message was dropped.
+    bool push(cc_tools_qt::ToolsDataInfoPtr dataPtr, int qos, SpoolId spoolId = 0U);
+
+    // Passes all the queued messages to the provided functor in order and
+    // clears the queue.
+    template <typename TFunc>
+    void drain(TFunc&& func)
+    {
+        auto ring = std::move(m_ring);
+        auto head = m_head;
+        auto used = m_used;
+        m_ring.clear();
+        resetState();
+
+        auto mask = ring.size() - 1U;
+        for (auto idx = 0U; idx < used; ++idx) {
+            auto& elem = ring[(head + idx) & mask];
+            if (elem.m_dataPtr) {
+                func(std::move(elem.m_dataPtr), elem.m_spoolId);
+            }
+        }
+
+        if (m_ring.empty()) {
+            // Reuse the storage
+            m_ring = std::move(ring);
+        }
+    }
+
+    void clear();
+
+    std::size_t size() const
+    {
+        return m_live;
+    }
+
+    bool empty() const
+    {
+        return m_live == 0U;
+    }
+
+    std::size_t bytes() const
+    {
+        return m_bytes;
+    }
+
+    std::uint64_t dropped() const
+    {
+        return m_dropped;
+    }
+
+    std::uint64_t droppedBytes() const
+    {
+        return m_droppedBytes;
+    }
+
+    void resetStats()
+    {
+        m_dropped = 0U;
+        m_droppedBytes = 0U;
+    }
+
+private:
+    static constexpr std::size_t MinCapacity = 16U; // must be power of 2
+
+    struct Elem
+    {
+        cc_tools_qt::ToolsDataInfoPtr m_dataPtr;
+        std::size_t m_bytes = 0U;
+        SpoolId m_spoolId = 0U;
+        int m_qos = 0;
+    };
+
+    Elem& slot(std::size_t idx)
+    {
+        return m_ring[(m_head + idx) & (m_ring.size() - 1U)];
+    }
+
+    bool exceedsLimits(std::size_t bytes) const;
+    void dropFront();
+    bool dropOldestQos0();
+    void dropAt(std::size_t idx);
+    void trimFront();
+    void reallocate();
+    void resetState();
+
+    std::vector<Elem> m_ring;
+    std::size_t m_head = 0U;
+    std::size_t m_used = 0U; // including dropped slots
+    std::size_t m_live = 0U;
+    std::size_t m_bytes = 0U;
+    std::size_t m_qos0Count = 0U;
+    std::size_t m_qos0Cursor = 0U; // no live QoS0 messages before this position
+    std::size_t m_countLimit = 0U;
+    std::size_t m_bytesLimit = 0U;
+    std::uint64_t m_dropped = 0U;
+    std::uint64_t m_droppedBytes = 0U;
+    DropPolicy m_policy = DropPolicy_Oldest;
+    DropHandler m_dropHandler;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
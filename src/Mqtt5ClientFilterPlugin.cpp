@@ -39,6 +39,22 @@ const QString KeepAliveKey("keep_alive");
 const QString SessionExpKey("session_exp");
 const QString SessionExpInfiniteKey("session_exp_infinite");
 const QString TopicAliasMaxKey("topic_alias_max");
+const QString RecvBufCapacityKey("recv_buf_capacity");
+const QString RecvPropGroupsKey("recv_prop_groups");
+const QString MetricsDumpPeriodKey("metrics_dump_period");
+const QString SendBatchSizeKey("send_batch_size");
+const QString AutoTopicAliasesKey("auto_topic_aliases");
+const QString SendQueueLimitKey("send_queue_limit");
+const QString PendingCountLimitKey("pending_count_limit");
+const QString PendingBytesLimitKey("pending_bytes_limit");
+const QString PendingDropPolicyKey("pending_drop_policy");
+const QString SpoolFileKey("spool_file");
+const QString SpoolSegmentSizeKey("spool_segment_size");
+const QString CompressThresholdKey("compress_threshold");
+const QString CompressLevelKey("compress_level");
+const QString DecompressMaxSizeKey("decompress_max_size");
+const QString RpcTimeoutKey("rpc_timeout");
+const QString WorkerThreadKey("worker_thread");
 const QString ForceCleanStartSubKey("force_clean_start");
 const QString PubTopicSubKey("pub_topic");
 const QString PubQosSubKey("pub_qos");
@@ -52,6 +68,9 @@ const QString SubNoLocalKey("sub_no_local");
 const QString SubRetainAsPublishedKey("sub_retain_as_published");
 const QString SubRetainHandlingKey("sub_retain_handling");
 const QString SubscribesSubKey("subscribes");
+const QString UserPropSetsSubKey("user_prop_sets");
+const QString UserPropKeySubKey("key");
+const QString UserPropValueSubKey("value");
 
 
 template <typename T>
@@ -117,6 +136,46 @@ QVariantList toVariantList(const Mqtt5ClientFilter::TopicAliasConfigsList& confi
     return result;
 }
 
+QVariantMap toVariantMap(const Mqtt5ClientFilter::UserPropSetsMap& sets)
+{
+    QVariantMap result;
+    for (auto& setElem : sets) {
+        QVariantList propsList;
+        for (auto& prop : setElem.second) {
+            QVariantMap propMap;
+            propMap[UserPropKeySubKey] = prop.m_key;
+            propMap[UserPropValueSubKey] = prop.m_value;
+            propsList.append(propMap);
+        }
+
+        result[setElem.first] = propsList;
+    }
+    return result;
+}
+
+void getUserPropSetsFromConfigMap(const QVariantMap& subConfig, Mqtt5ClientFilter::UserPropSetsMap& sets)
+{
+    sets.clear();
+
+    auto var = subConfig.value(UserPropSetsSubKey);
+    if ((!var.isValid()) || (!var.canConvert<QVariantMap>())) {
+        return;
+    }    
+
+    auto setsMap = var.value<QVariantMap>();
+    for (auto iter = setsMap.begin(); iter != setsMap.end(); ++iter) {
+        auto& userProps = sets[iter.key()];
+        auto propsList = iter.value().value<QVariantList>();
+        for (auto& propVar : propsList) {
+            auto propMap = propVar.value<QVariantMap>();
+            userProps.push_back(
+                Mqtt5ClientFilter::UserPropConfig{
+                    propMap.value(UserPropKeySubKey).toString(), 
+                    propMap.value(UserPropValueSubKey).toString()});
+        }
+    }
+}
+
 template <typename T>
 void getListFromConfigMap(const QVariantMap& subConfig, const QString& key, T& list)
 {
@@ -128,6 +187,7 @@ void getListFromConfigMap(const QVariantMap& subConfig, const QString& key, T& l
     }    
 
     auto varList = var.value<QVariantList>();
+    list.reserve(static_cast<std::size_t>(varList.size()));
     for (auto& elemVar : varList) {
 
         if ((!elemVar.isValid()) || (!elemVar.canConvert<QVariantMap>())) {
@@ -136,8 +196,9 @@ void getListFromConfigMap(const QVariantMap& subConfig, const QString& key, T& l
 
         auto varMap = elemVar.value<QVariantMap>();
 
-        list.resize(list.size() + 1U);
-        fromVariantMap(varMap, list.back());
+        typename T::value_type elem;
+        fromVariantMap(varMap, elem);
+        list.append(std::move(elem));
     }
 }
 
@@ -165,12 +226,29 @@ void Mqtt5ClientFilterPlugin::getCurrentConfigImpl(QVariantMap& config)
     subConfig.insert(SessionExpKey, m_filter->config().m_sessionExpiryInterval);
     subConfig.insert(SessionExpInfiniteKey, m_filter->config().m_sessionExpiryInfinite);
     subConfig.insert(TopicAliasMaxKey, m_filter->config().m_topicAliasMaximum);
+    subConfig.insert(RecvBufCapacityKey, m_filter->config().m_recvBufCapacity);
+    subConfig.insert(RecvPropGroupsKey, m_filter->config().m_recvPropGroups);
+    subConfig.insert(MetricsDumpPeriodKey, m_filter->config().m_metricsDumpPeriod);
+    subConfig.insert(SendBatchSizeKey, m_filter->config().m_sendBatchSize);
+    subConfig.insert(AutoTopicAliasesKey, m_filter->config().m_autoTopicAliases);
+    subConfig.insert(SendQueueLimitKey, m_filter->config().m_sendQueueLimit);
+    subConfig.insert(PendingCountLimitKey, m_filter->config().m_pendingCountLimit);
+    subConfig.insert(PendingBytesLimitKey, m_filter->config().m_pendingBytesLimit);
+    subConfig.insert(PendingDropPolicyKey, m_filter->config().m_pendingDropPolicy);
+    subConfig.insert(SpoolFileKey, m_filter->config().m_spoolFile);
+    subConfig.insert(SpoolSegmentSizeKey, m_filter->config().m_spoolSegmentSize);
+    subConfig.insert(CompressThresholdKey, m_filter->config().m_compressThreshold);
+    subConfig.insert(CompressLevelKey, m_filter->config().m_compressLevel);
+    subConfig.insert(DecompressMaxSizeKey, m_filter->config().m_decompressMaxSize);
+    subConfig.insert(RpcTimeoutKey, m_filter->config().m_rpcTimeout);
+    subConfig.insert(WorkerThreadKey, m_filter->config().m_workerThread);
     subConfig.insert(ForceCleanStartSubKey, m_filter->config().m_forcedCleanStart);
     subConfig.insert(PubTopicSubKey, m_filter->config().m_pubTopic);
     subConfig.insert(PubQosSubKey, m_filter->config().m_pubQos);
     subConfig.insert(RespTopicSubKey, m_filter->config().m_respTopic);
     subConfig.insert(SubscribesSubKey, toVariantList(m_filter->config().m_subscribes));
     subConfig.insert(TopicAliasesSubKey, toVariantList(m_filter->config().m_topicAliases));
+    subConfig.insert(UserPropSetsSubKey, toVariantMap(m_filter->config().m_userPropSets));
     config.insert(MainConfigKey, QVariant::fromValue(subConfig));
 }
 
@@ -186,20 +264,44 @@ void Mqtt5ClientFilterPlugin::reconfigureImpl(const QVariantMap& config)
 
     auto subConfig = subConfigVar.value<QVariantMap>();
 
-    getFromConfigMap(subConfig, RespTimeoutSubKey, m_filter->config().m_respTimeout);
-    getFromConfigMap(subConfig, ClientIdSubKey, m_filter->config().m_clientId);
-    getFromConfigMap(subConfig, UsernameSubKey, m_filter->config().m_username);
-    getFromConfigMap(subConfig, PasswordSubKey, m_filter->config().m_password);
-    getFromConfigMap(subConfig, KeepAliveKey, m_filter->config().m_keepAlive);
-    getFromConfigMap(subConfig, SessionExpKey, m_filter->config().m_sessionExpiryInterval);
-    getFromConfigMap(subConfig, SessionExpInfiniteKey, m_filter->config().m_sessionExpiryInfinite);
-    getFromConfigMap(subConfig, TopicAliasMaxKey, m_filter->config().m_topicAliasMaximum);
-    getFromConfigMap(subConfig, ForceCleanStartSubKey, m_filter->config().m_forcedCleanStart);
-    getFromConfigMap(subConfig, PubTopicSubKey, m_filter->config().m_pubTopic);
-    getFromConfigMap(subConfig, PubQosSubKey, m_filter->config().m_pubQos);
-    getFromConfigMap(subConfig, RespTopicSubKey, m_filter->config().m_respTopic);
-    getListFromConfigMap(subConfig, SubscribesSubKey, m_filter->config().m_subscribes);
-    getListFromConfigMap(subConfig, TopicAliasesSubKey, m_filter->config().m_topicAliases);
+    m_filter->updateConfig(
+        [&subConfig](Mqtt5ClientFilter::Config& config)
+        {
+            getFromConfigMap(subConfig, RespTimeoutSubKey, config.m_respTimeout);
+            getFromConfigMap(subConfig, ClientIdSubKey, config.m_clientId);
+            getFromConfigMap(subConfig, UsernameSubKey, config.m_username);
+            getFromConfigMap(subConfig, PasswordSubKey, config.m_password);
+            getFromConfigMap(subConfig, KeepAliveKey, config.m_keepAlive);
+            getFromConfigMap(subConfig, SessionExpKey, config.m_sessionExpiryInterval);
+            getFromConfigMap(subConfig, SessionExpInfiniteKey, config.m_sessionExpiryInfinite);
+            getFromConfigMap(subConfig, TopicAliasMaxKey, config.m_topicAliasMaximum);
+            getFromConfigMap(subConfig, RecvBufCapacityKey, config.m_recvBufCapacity);
+            getFromConfigMap(subConfig, RecvPropGroupsKey, config.m_recvPropGroups);
+            getFromConfigMap(subConfig, MetricsDumpPeriodKey, config.m_metricsDumpPeriod);
+            getFromConfigMap(subConfig, SendBatchSizeKey, config.m_sendBatchSize);
+            getFromConfigMap(subConfig, AutoTopicAliasesKey, config.m_autoTopicAliases);
+            getFromConfigMap(subConfig, SendQueueLimitKey, config.m_sendQueueLimit);
+            getFromConfigMap(subConfig, PendingCountLimitKey, config.m_pendingCountLimit);
+            getFromConfigMap(subConfig, PendingBytesLimitKey, config.m_pendingBytesLimit);
+            getFromConfigMap(subConfig, PendingDropPolicyKey, config.m_pendingDropPolicy);
+            getFromConfigMap(subConfig, SpoolFileKey, config.m_spoolFile);
+            getFromConfigMap(subConfig, SpoolSegmentSizeKey, config.m_spoolSegmentSize);
+            getFromConfigMap(subConfig, CompressThresholdKey, config.m_compressThreshold);
+            getFromConfigMap(subConfig, CompressLevelKey, config.m_compressLevel);
+            getFromConfigMap(subConfig, DecompressMaxSizeKey, config.m_decompressMaxSize);
+            getFromConfigMap(subConfig, RpcTimeoutKey, config.m_rpcTimeout);
+            getFromConfigMap(subConfig, WorkerThreadKey, config.m_workerThread);
+            getFromConfigMap(subConfig, ForceCleanStartSubKey, config.m_forcedCleanStart);
+            getFromConfigMap(subConfig, PubTopicSubKey, config.m_pubTopic);
+            getFromConfigMap(subConfig, PubQosSubKey, config.m_pubQos);
+            getFromConfigMap(subConfig, RespTopicSubKey, config.m_respTopic);
+            getListFromConfigMap(subConfig, SubscribesSubKey, config.m_subscribes);
+            getListFromConfigMap(subConfig, TopicAliasesSubKey, config.m_topicAliases);
+            getUserPropSetsFromConfigMap(subConfig, config.m_userPropSets);
+        });
+
+    m_filter->publishConfigUpdated();
+    m_filter->subscribesUpdated();
 }
 
 void Mqtt5ClientFilterPlugin::applyInterPluginConfigImpl(const QVariantMap& props)
@@ -0,0 +1,91 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterRecvBuffer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+Mqtt5ClientFilterRecvBuffer::Mqtt5ClientFilterRecvBuffer() :
+    m_storage(DefaultCapacity)
+{
+}
+
+void Mqtt5ClientFilterRecvBuffer::setCapacity(std::size_t value)
+{
+    value = std::max(value, size());
+    if (value == capacity()) {
+        return;
+    }
+
+    reallocate(value);
+}
+
+void Mqtt5ClientFilterRecvBuffer::append(const std::uint8_t* buf, std::size_t bufLen)
+{
+    if (bufLen == 0U) {
+        return;
+    }
+
+    auto requiredLen = size() + bufLen;
+    if (capacity() < requiredLen) {
+        reallocate(std::max(requiredLen, capacity() * 2U));
+    }
+    else if (capacity() < (m_end + bufLen)) {
+        // Move the remaining partial packet to the front only when the tail space is exhausted
+        std::memmove(m_storage.data(), m_storage.data() + m_begin, size());
+        m_end -= m_begin;
+        m_begin = 0U;
+    }
+
+    assert((m_end + bufLen) <= capacity());
+    std::memcpy(m_storage.data() + m_end, buf, bufLen);
+    m_end += bufLen;
+    m_highWaterMark = std::max(m_highWaterMark, size());
+}
+
+void Mqtt5ClientFilterRecvBuffer::consume(std::size_t len)
+{
+    assert(len <= size());
+    m_begin += std::min(len, size());
+    if (m_begin == m_end) {
+        clear();
+    }
+}
+
+void Mqtt5ClientFilterRecvBuffer::clear()
+{
+    m_begin = 0U;
+    m_end = 0U;
+}
+
+void Mqtt5ClientFilterRecvBuffer::reallocate(std::size_t newCapacity)
+{
+    assert(size() <= newCapacity);
+    std::vector<std::uint8_t> newStorage(newCapacity);
+    std::copy(m_storage.begin() + static_cast<std::ptrdiff_t>(m_begin), m_storage.begin() + static_cast<std::ptrdiff_t>(m_end), newStorage.begin());
+    m_end -= m_begin;
+    m_begin = 0U;
+    m_storage.swap(newStorage);
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
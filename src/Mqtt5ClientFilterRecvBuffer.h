@@ -0,0 +1,85 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Receive buffer which doesn't shift the remaining bytes on every consumption.
+// The data is kept contiguous, the storage is compacted only when the appended
+// data doesn't fit at the end, and it grows when the capacity is exceeded.
+class Mqtt5ClientFilterRecvBuffer
+{
+public:
+    static constexpr std::size_t DefaultCapacity = 64U * 1024U;
+
+    Mqtt5ClientFilterRecvBuffer();
+
+    std::size_t capacity() const
+    {
+        return m_storage.size();
+    }
+
+    void setCapacity(std::size_t value);
+
+    const std::uint8_t* data() const
+    {
+        return m_storage.data() + m_begin;
+    }
+
+    std::size_t size() const
+    {
+        return m_end - m_begin;
+    }
+
+    bool empty() const
+    {
+        return m_begin == m_end;
+    }
+
+    std::size_t highWaterMark() const
+    {
+        return m_highWaterMark;
+    }
+
+    void resetHighWaterMark()
+    {
+        m_highWaterMark = size();
+    }
+
+    void append(const std::uint8_t* buf, std::size_t bufLen);
+    void consume(std::size_t len);
+    void clear();
+
+private:
+    void reallocate(std::size_t newCapacity);
+
+    std::vector<std::uint8_t> m_storage;
+    std::size_t m_begin = 0U;
+    std::size_t m_end = 0U;
+    std::size_t m_highWaterMark = 0U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+
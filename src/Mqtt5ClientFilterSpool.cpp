@@ -0,0 +1,258 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterSpool.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDataStream>
+#include <QtCore/QIODevice>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace 
+{
+
+const char Magic[] = "CCMQ5SPL";
+const std::size_t MagicLen = sizeof(Magic) - 1U;
+const std::uint8_t Version = 1U;
+const auto StreamVersion = QDataStream::Qt_5_15;
+
+} // namespace 
+
+Mqtt5ClientFilterSpool::~Mqtt5ClientFilterSpool() noexcept
+{
+    close();
+}
+
+bool Mqtt5ClientFilterSpool::open(const QString& path, std::size_t segmentSize, RecoveredList& recovered)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+
+    auto size = std::max(static_cast<std::size_t>(m_file.size()), std::max(segmentSize, HeaderSize + RecordHeaderSize));
+    if ((static_cast<std::size_t>(m_file.size()) < size) && (!m_file.resize(static_cast<qint64>(size)))) {
+        m_file.close();
+        return false;
+    }
+
+    m_map = m_file.map(0, static_cast<qint64>(size));
+    if (m_map == nullptr) {
+        m_file.close();
+        return false;
+    }
+
+    m_size = size;
+    if ((std::memcmp(m_map, Magic, MagicLen) != 0) || (m_map[MagicLen] != Version)) {
+        std::memset(m_map, 0, m_size);
+        initHeader();
+        m_writePos = HeaderSize;
+        return true;
+    }
+
+    recover(recovered);
+    return true;
+}
+
+void Mqtt5ClientFilterSpool::close()
+{
+    if (m_map != nullptr) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+
+    m_size = 0U;
+    m_writePos = 0U;
+    m_ackedBytes = 0U;
+    m_offsets.clear();
+}
+
+Mqtt5ClientFilterSpool::Id Mqtt5ClientFilterSpool::append(const QVariantMap& props, const std::vector<std::uint8_t>& data)
+{
+    if (!isOpen()) {
+        return InvalidId;
+    }
+
+    QByteArray payload;
+    {
+        QDataStream stream(&payload, QIODevice::WriteOnly);
+        stream.setVersion(StreamVersion);
+        stream << props << QByteArray::fromRawData(reinterpret_cast<const char*>(data.data()), static_cast<int>(data.size()));
+    }
+
+    auto len = static_cast<std::size_t>(payload.size());
+    auto required = RecordHeaderSize + len;
+    // Compact only when it frees enough space, the spool which is full
+    // of live records doesn't resort them on every append attempt.
+    auto available = m_size - m_writePos;
+    if ((available < required) && (required <= (available + m_ackedBytes))) {
+        compact();
+    }
+
+    if ((m_size - m_writePos) < required) {
+        return InvalidId;
+    }
+
+    auto pos = m_writePos;
+    std::memcpy(m_map + pos + RecordHeaderSize, payload.constData(), len);
+    m_map[pos + sizeof(std::uint32_t)] = State_Live;
+    writeLength(pos, static_cast<std::uint32_t>(len));
+    m_writePos += required;
+
+    auto id = m_nextId;
+    ++m_nextId;
+    m_offsets.emplace(id, pos);
+    return id;
+}
+
+void Mqtt5ClientFilterSpool::ack(Id id)
+{
+    auto iter = m_offsets.find(id);
+    if (iter == m_offsets.end()) {
+        return;
+    }
+
+    assert(isOpen());
+    m_map[iter->second + sizeof(std::uint32_t)] = State_Acked;
+    m_ackedBytes += RecordHeaderSize + readLength(iter->second);
+    m_offsets.erase(iter);
+
+    if (m_offsets.empty()) {
+        reset();
+    }
+}
+
+cc_tools_qt::ToolsDataInfoPtr Mqtt5ClientFilterSpool::read(Id id) const
+{
+    auto iter = m_offsets.find(id);
+    if (iter == m_offsets.end()) {
+        return cc_tools_qt::ToolsDataInfoPtr();
+    }
+
+    assert(isOpen());
+    return readRecord(iter->second);
+}
+
+void Mqtt5ClientFilterSpool::initHeader()
+{
+    std::memcpy(m_map, Magic, MagicLen);
+    m_map[MagicLen] = Version;
+}
+
+void Mqtt5ClientFilterSpool::recover(RecoveredList& recovered)
+{
+    auto pos = HeaderSize;
+    while ((pos + RecordHeaderSize) <= m_size) {
+        auto len = static_cast<std::size_t>(readLength(pos));
+        if ((len == 0U) || ((m_size - pos - RecordHeaderSize) < len)) {
+            break;
+        }
+
+        if (m_map[pos + sizeof(std::uint32_t)] == State_Live) {
+            auto dataInfo = readRecord(pos);
+            if (dataInfo) {
+                auto id = m_nextId;
+                ++m_nextId;
+                m_offsets.emplace(id, pos);
+                recovered.emplace_back(id, std::move(dataInfo));
+            }
+        }
+
+        pos += RecordHeaderSize + len;
+    }
+
+    m_writePos = pos;
+    compact();
+}
+
+void Mqtt5ClientFilterSpool::compact()
+{
+    std::vector<std::pair<std::size_t, Id>> live;
+    live.reserve(m_offsets.size());
+    for (auto& elem : m_offsets) {
+        live.emplace_back(elem.second, elem.first);
+    }
+    std::sort(live.begin(), live.end());
+
+    auto pos = HeaderSize;
+    for (auto& elem : live) {
+        auto recLen = RecordHeaderSize + readLength(elem.first);
+        if (elem.first != pos) {
+            std::memmove(m_map + pos, m_map + elem.first, recLen);
+            m_offsets[elem.second] = pos;
+        }
+
+        pos += recLen;
+    }
+
+    assert(pos <= m_writePos);
+    std::memset(m_map + pos, 0, m_writePos - pos);
+    m_writePos = pos;
+    m_ackedBytes = 0U;
+}
+
+void Mqtt5ClientFilterSpool::reset()
+{
+    assert(m_offsets.empty());
+    std::memset(m_map + HeaderSize, 0, m_writePos - HeaderSize);
+    m_writePos = HeaderSize;
+    m_ackedBytes = 0U;
+}
+
+cc_tools_qt::ToolsDataInfoPtr Mqtt5ClientFilterSpool::readRecord(std::size_t pos) const
+{
+    auto len = readLength(pos);
+    auto payload = QByteArray::fromRawData(reinterpret_cast<const char*>(m_map + pos + RecordHeaderSize), static_cast<int>(len));
+    QDataStream stream(payload);
+    stream.setVersion(StreamVersion);
+
+    auto dataInfo = cc_tools_qt::makeDataInfoTimed();
+    QByteArray data;
+    stream >> dataInfo->m_extraProperties >> data;
+    if (stream.status() != QDataStream::Ok) {
+        return cc_tools_qt::ToolsDataInfoPtr();
+    }
+
+    dataInfo->m_data.assign(data.begin(), data.end());
+    return dataInfo;
+}
+
+std::uint32_t Mqtt5ClientFilterSpool::readLength(std::size_t pos) const
+{
+    std::uint32_t result = 0U;
+    std::memcpy(&result, m_map + pos, sizeof(result));
+    return result;
+}
+
+void Mqtt5ClientFilterSpool::writeLength(std::size_t pos, std::uint32_t len)
+{
+    std::memcpy(m_map + pos, &len, sizeof(len));
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,106 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cc_tools_qt/ToolsDataInfo.h>
+
+#include <QtCore/QFile>
+#include <QtCore/QString>
+#include <QtCore/QVariantMap>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Append-only memory-mapped spool of the outgoing messages which haven't been
+// acknowledged yet. Every record starts with its payload length and state byte,
+// acknowledgement just updates the state byte in place. The acknowledged
+// records are reclaimed when the segment is full and the reclaimed space is
+// sufficient for the new record, or when no record is live.
+// The mapped memory is flushed by the OS, there is no explicit sync.
+class Mqtt5ClientFilterSpool
+{
+public:
+    using Id = std::uint64_t;
+    using RecoveredList = std::vector<std::pair<Id, cc_tools_qt::ToolsDataInfoPtr>>;
+
+    static constexpr Id InvalidId = 0U;
+    static constexpr std::size_t DefaultSegmentSize = 16U * 1024U * 1024U;
+
+    ~Mqtt5ClientFilterSpool() noexcept;
+
+    // Returns the live records of the previous session.
+    bool open(const QString& path, std::size_t segmentSize, RecoveredList& recovered);
+    void close();
+
+    bool isOpen() const
+    {
+        return m_map != nullptr;
+    }
+
+    Id append(const QVariantMap& props, const std::vector<std::uint8_t>& data);
+    void ack(Id id);
+
+    // Reads back the live record, returns empty pointer if it doesn't exist.
+    cc_tools_qt::ToolsDataInfoPtr read(Id id) const;
+
+    std::size_t liveCount() const
+    {
+        return m_offsets.size();
+    }
+
+    std::size_t usedBytes() const
+    {
+        return m_writePos;
+    }
+
+private:
+    enum State : std::uint8_t
+    {
+        State_Free,
+        State_Live,
+        State_Acked,
+    };
+
+    static constexpr std::size_t HeaderSize = 16U;
+    static constexpr std::size_t RecordHeaderSize = 5U; // length + state
+
+    void initHeader();
+    void recover(RecoveredList& recovered);
+    void compact();
+    void reset();
+    cc_tools_qt::ToolsDataInfoPtr readRecord(std::size_t pos) const;
+    std::uint32_t readLength(std::size_t pos) const;
+    void writeLength(std::size_t pos, std::uint32_t len);
+
+    QFile m_file;
+    std::uint8_t* m_map = nullptr;
+    std::size_t m_size = 0U;
+    std::size_t m_writePos = 0U;
+    std::size_t m_ackedBytes = 0U; // reclaimable by the compaction
+    std::unordered_map<Id, std::size_t> m_offsets;
+    Id m_nextId = InvalidId + 1U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,99 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Bounded lock-free queue for a single producer and a single consumer thread.
+// The capacity is rounded up to the power of 2.
+template <typename T>
+class Mqtt5ClientFilterSpscQueue
+{
+public:
+    explicit Mqtt5ClientFilterSpscQueue(std::size_t capacity)
+    {
+        std::size_t actualCapacity = 2U;
+        while (actualCapacity < capacity) {
+            actualCapacity <<= 1U;
+        }
+
+        m_buf.reset(new T[actualCapacity]);
+        m_mask = actualCapacity - 1U;
+    }
+
+    // Producer side, returns false when full
+    bool push(T&& elem)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if ((tail - m_headCache) > m_mask) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if ((tail - m_headCache) > m_mask) {
+                return false;
+            }
+        }
+
+        m_buf[tail & m_mask] = std::move(elem);
+        m_tail.store(tail + 1U, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, returns false when empty
+    bool pop(T& elem)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tailCache) {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head == m_tailCache) {
+                return false;
+            }
+        }
+
+        elem = std::move(m_buf[head & m_mask]);
+        m_buf[head & m_mask] = T();
+        m_head.store(head + 1U, std::memory_order_release);
+        return true;
+    }
+
+    std::size_t capacity() const
+    {
+        return m_mask + 1U;
+    }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64U;
+
+    std::unique_ptr<T[]> m_buf;
+    std::size_t m_mask = 0U;
+
+    // Written by the consumer
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head{0U};
+    std::size_t m_tailCache = 0U;
+
+    // Written by the producer
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail{0U};
+    std::size_t m_headCache = 0U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
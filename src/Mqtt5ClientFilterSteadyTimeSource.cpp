@@ -0,0 +1,82 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterSteadyTimeSource.h"
+
+#include <QtCore/QTimer>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace 
+{
+
+class SteadyTimer final : public Mqtt5ClientFilterTimer
+{
+public:
+    SteadyTimer()
+    {
+        m_timer.setSingleShot(true);
+        m_timer.setTimerType(Qt::PreciseTimer);
+
+        // Invoked in the context of the timer's thread
+        QObject::connect(
+            &m_timer, &QTimer::timeout,
+            [this]()
+            {
+                reportTimeout();
+            });
+    }
+
+protected:
+    virtual void startImpl(std::chrono::milliseconds timeout) override
+    {
+        m_timer.start(static_cast<int>(timeout.count()));
+    }
+
+    virtual void stopImpl() override
+    {
+        m_timer.stop();
+    }
+
+    virtual bool isActiveImpl() const override
+    {
+        return m_timer.isActive();
+    }
+
+    virtual void moveToThreadImpl(QThread* thread) override
+    {
+        m_timer.moveToThread(thread);
+    }
+
+private:
+    QTimer m_timer;
+};
+
+} // namespace 
+
+Mqtt5ClientFilterSteadyTimeSource::TimePoint Mqtt5ClientFilterSteadyTimeSource::nowImpl() const
+{
+    return Clock::now();
+}
+
+Mqtt5ClientFilterTimerPtr Mqtt5ClientFilterSteadyTimeSource::createTimerImpl()
+{
+    return std::make_unique<SteadyTimer>();
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,33 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Mqtt5ClientFilterTimeSource.h"
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Real monotonic time with the precise Qt timers.
+class Mqtt5ClientFilterSteadyTimeSource final : public Mqtt5ClientFilterTimeSource
+{
+protected:
+    virtual TimePoint nowImpl() const override;
+    virtual Mqtt5ClientFilterTimerPtr createTimerImpl() override;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,74 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterStrCache.h"
+
+#include <cassert>
+#include <cstring>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+Mqtt5ClientFilterStrCache::Mqtt5ClientFilterStrCache(std::size_t capacity) :
+    m_capacity(capacity)
+{
+    m_map.reserve(static_cast<int>(m_capacity));
+}
+
+QString Mqtt5ClientFilterStrCache::intern(const char* str)
+{
+    assert(str != nullptr);
+    auto len = static_cast<int>(std::strlen(str));
+    auto iter = m_map.constFind(QByteArray::fromRawData(str, len));
+    if (iter != m_map.constEnd()) {
+        ++m_hits;
+        return iter.value();
+    }
+
+    ++m_misses;
+    auto result = QString::fromUtf8(str, len);
+    if (m_capacity == 0U) {
+        return result;
+    }
+
+    if (m_capacity <= static_cast<std::size_t>(m_map.size())) {
+        m_map.clear();
+    }
+
+    m_map.insert(QByteArray(str, len), result);
+    return result;
+}
+
+void Mqtt5ClientFilterStrCache::clear()
+{
+    m_map.clear();
+    m_hits = 0U;
+    m_misses = 0U;
+}
+
+double Mqtt5ClientFilterStrCache::hitRate() const
+{
+    auto total = m_hits + m_misses;
+    if (total == 0U) {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_hits) / static_cast<double>(total);
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
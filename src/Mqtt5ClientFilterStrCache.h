@@ -0,0 +1,72 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Bounded intern table of the received strings (topics, content types, etc...)
+// keyed by their UTF-8 bytes. Returns the implicitly shared QString, which
+// avoids decoding and allocation for the repeating values. When the limit
+// is reached the table is cleared and populated again.
+class Mqtt5ClientFilterStrCache
+{
+public:
+    static constexpr std::size_t DefaultCapacity = 4096U;
+
+    explicit Mqtt5ClientFilterStrCache(std::size_t capacity = DefaultCapacity);
+
+    QString intern(const char* str);
+    void clear();
+
+    std::uint64_t hits() const
+    {
+        return m_hits;
+    }
+
+    std::uint64_t misses() const
+    {
+        return m_misses;
+    }
+
+    double hitRate() const;
+
+    void resetStats()
+    {
+        m_hits = 0U;
+        m_misses = 0U;
+    }
+
+private:
+    QHash<QByteArray, QString> m_map;
+    std::size_t m_capacity = DefaultCapacity;
+    std::uint64_t m_hits = 0U;
+    std::uint64_t m_misses = 0U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
+
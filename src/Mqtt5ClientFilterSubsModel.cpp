@@ -0,0 +1,222 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterSubsModel.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+namespace 
+{
+
+const int MaxQos = 2;
+const int MaxRetainHandling = 2;
+
+QVariant checkState(bool value)
+{
+    return value ? Qt::Checked : Qt::Unchecked;
+}
+
+} // namespace 
+
+Mqtt5ClientFilterSubsModel::Mqtt5ClientFilterSubsModel(Mqtt5ClientFilter& filter, QObject* parentObj) :
+    Base(filter.config().m_subscribes, parentObj),
+    m_filter(filter)
+{
+}
+
+int Mqtt5ClientFilterSubsModel::columnCount(const QModelIndex& parentIdx) const
+{
+    if (parentIdx.isValid()) {
+        return 0;
+    }
+
+    return Column_ValuesLimit;
+}
+
+QVariant Mqtt5ClientFilterSubsModel::data(const QModelIndex& idx, int role) const
+{
+    auto* config = configAt(idx);
+    if (config == nullptr) {
+        return QVariant();
+    }
+
+    if (role == Qt::CheckStateRole) {
+        switch (idx.column()) {
+            case Column_NoLocal: return checkState(config->m_noLocal);
+            case Column_RetainAsPublished: return checkState(config->m_retainAsPublished);
+            default: return QVariant();
+        }
+    }
+
+    if ((role != Qt::DisplayRole) && (role != Qt::EditRole)) {
+        return QVariant();
+    }
+
+    switch (idx.column()) {
+        case Column_Topic: return config->m_topic;
+        case Column_MaxQos: return config->m_maxQos;
+        case Column_RetainHandling: break;
+        default: return QVariant();
+    }
+
+    if (role == Qt::EditRole) {
+        return config->m_retainHandling;
+    }
+
+    static const QString RetainHandlingStr[] = {
+        tr("Send"),
+        tr("Send If Does Not Exist"),
+        tr("Do Not Send"),
+    };
+    static const std::size_t RetainHandlingStrCount = std::extent<decltype(RetainHandlingStr)>::value;
+    static_assert(RetainHandlingStrCount == MaxRetainHandling + 1);
+
+    if (RetainHandlingStrCount <= static_cast<unsigned>(config->m_retainHandling)) {
+        return config->m_retainHandling;
+    }
+
+    return RetainHandlingStr[config->m_retainHandling];
+}
+
+bool Mqtt5ClientFilterSubsModel::setData(const QModelIndex& idx, const QVariant& value, int role)
+{
+    auto* currConfig = configAt(idx);
+    if (currConfig == nullptr) {
+        return false;
+    }
+
+    if ((role == Qt::EditRole) && (idx.column() == Column_Topic) && (currConfig->m_topic == value.toString())) {
+        return true;
+    }
+
+    bool updated = updateConfigAt(
+        idx,
+        [&idx, &value, role](ConfigsList& configs, Mqtt5ClientFilter::SubConfig& config)
+        {
+            if (role == Qt::CheckStateRole) {
+                bool checked = (value.toInt() == Qt::Checked);
+                switch (idx.column()) {
+                    case Column_NoLocal: config.m_noLocal = checked; return true;
+                    case Column_RetainAsPublished: config.m_retainAsPublished = checked; return true;
+                    default: return false;
+                }
+            }
+
+            if (role != Qt::EditRole) {
+                return false;
+            }
+
+            switch (idx.column()) {
+                case Column_Topic: 
+                    configs.setTopic(config, value.toString()); 
+                    return true;
+
+                case Column_MaxQos: {
+                    auto qos = value.toInt();
+                    if ((qos < 0) || (MaxQos < qos)) {
+                        return false;
+                    }
+
+                    config.m_maxQos = qos;
+                    return true;
+                }
+
+                case Column_RetainHandling: {
+                    auto retainHandling = value.toInt();
+                    if ((retainHandling < 0) || (MaxRetainHandling < retainHandling)) {
+                        return false;
+                    }
+
+                    config.m_retainHandling = retainHandling;
+                    return true;
+                }
+
+                default: 
+                    return false;
+            }
+        });
+
+    if (!updated) {
+        return false;
+    }
+
+    emit dataChanged(idx, idx);
+    configsUpdated();
+    return true;
+}
+
+Qt::ItemFlags Mqtt5ClientFilterSubsModel::flags(const QModelIndex& idx) const
+{
+    auto result = Base::flags(idx);
+    if (!idx.isValid()) {
+        return result;
+    }
+
+    switch (idx.column()) {
+        case Column_NoLocal: 
+        case Column_RetainAsPublished: 
+            return result | Qt::ItemIsUserCheckable;
+
+        default:
+            break;
+    }
+
+    return result | Qt::ItemIsEditable;
+}
+
+QVariant Mqtt5ClientFilterSubsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation != Qt::Horizontal) || (role != Qt::DisplayRole)) {
+        return Base::headerData(section, orientation, role);
+    }
+
+    static const QString Headers[] = {
+        tr("Topic Filter"),
+        tr("Max QoS"),
+        tr("No Local"),
+        tr("Retain As Published"),
+        tr("Retain Handling"),
+    };
+    static const std::size_t HeadersCount = std::extent<decltype(Headers)>::value;
+    static_assert(HeadersCount == Column_ValuesLimit);
+
+    if ((section < 0) || (HeadersCount <= static_cast<unsigned>(section))) {
+        return QVariant();
+    }
+
+    return Headers[section];
+}
+
+void Mqtt5ClientFilterSubsModel::updateConfigs(const UpdateFunc& func)
+{
+    m_filter.updateConfig(
+        [&func](Mqtt5ClientFilter::Config& config)
+        {
+            func(config.m_subscribes);
+        });
+}
+
+void Mqtt5ClientFilterSubsModel::configsUpdated()
+{
+    m_filter.subscribesUpdated();
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,57 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Mqtt5ClientFilter.h"
+#include "Mqtt5ClientFilterTopicConfigsModel.h"
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+class Mqtt5ClientFilterSubsModel : public Mqtt5ClientFilterTopicConfigsModel<Mqtt5ClientFilter::SubConfig>
+{
+    using Base = Mqtt5ClientFilterTopicConfigsModel<Mqtt5ClientFilter::SubConfig>;
+
+public:
+    enum Column
+    {
+        Column_Topic,
+        Column_MaxQos,
+        Column_NoLocal,
+        Column_RetainAsPublished,
+        Column_RetainHandling,
+        Column_ValuesLimit
+    };
+
+    explicit Mqtt5ClientFilterSubsModel(Mqtt5ClientFilter& filter, QObject* parentObj = nullptr);
+
+    virtual int columnCount(const QModelIndex& parentIdx = QModelIndex()) const override;
+    virtual QVariant data(const QModelIndex& idx, int role = Qt::DisplayRole) const override;
+    virtual bool setData(const QModelIndex& idx, const QVariant& value, int role = Qt::EditRole) override;
+    virtual Qt::ItemFlags flags(const QModelIndex& idx) const override;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+protected:
+    virtual void updateConfigs(const UpdateFunc& func) override;
+    virtual void configsUpdated() override;
+
+private:
+    Mqtt5ClientFilter& m_filter;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
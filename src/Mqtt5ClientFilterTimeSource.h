@@ -0,0 +1,111 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <utility>
+
+class QThread;
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Single shot timer created by the time source.
+class Mqtt5ClientFilterTimer
+{
+public:
+    using TimeoutHandler = std::function<void()>;
+
+    virtual ~Mqtt5ClientFilterTimer() noexcept = default;
+
+    void start(std::chrono::milliseconds timeout)
+    {
+        startImpl(timeout);
+    }
+
+    void stop()
+    {
+        stopImpl();
+    }
+
+    bool isActive() const
+    {
+        return isActiveImpl();
+    }
+
+    void setTimeoutHandler(TimeoutHandler&& handler)
+    {
+        m_timeoutHandler = std::move(handler);
+    }
+
+    // Invoked when the client engine is moved to the other thread
+    void moveToThread(QThread* thread)
+    {
+        moveToThreadImpl(thread);
+    }
+
+protected:
+    virtual void startImpl(std::chrono::milliseconds timeout) = 0;
+    virtual void stopImpl() = 0;
+    virtual bool isActiveImpl() const = 0;
+    virtual void moveToThreadImpl([[maybe_unused]] QThread* thread) {}
+
+    void reportTimeout()
+    {
+        if (m_timeoutHandler) {
+            m_timeoutHandler();
+        }
+    }
+
+private:
+    TimeoutHandler m_timeoutHandler;
+};
+
+using Mqtt5ClientFilterTimerPtr = std::unique_ptr<Mqtt5ClientFilterTimer>;
+
+// Source of the time and the timers driving the client engine (client ticks,
+// RPC deadlines, send batching, metrics dump). The created timers must not
+// outlive the source.
+class Mqtt5ClientFilterTimeSource
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimePoint = Clock::time_point;
+
+    virtual ~Mqtt5ClientFilterTimeSource() noexcept = default;
+
+    TimePoint now() const
+    {
+        return nowImpl();
+    }
+
+    Mqtt5ClientFilterTimerPtr createTimer()
+    {
+        return createTimerImpl();
+    }
+
+protected:
+    virtual TimePoint nowImpl() const = 0;
+    virtual Mqtt5ClientFilterTimerPtr createTimerImpl() = 0;
+};
+
+using Mqtt5ClientFilterTimeSourcePtr = std::unique_ptr<Mqtt5ClientFilterTimeSource>;
+
+}  // namespace cc_plugin_mqtt5_client_filter
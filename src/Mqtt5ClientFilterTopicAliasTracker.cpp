@@ -0,0 +1,188 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterTopicAliasTracker.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+bool Mqtt5ClientFilterTopicAliasTracker::record(const std::string& topic)
+{
+    auto iter = m_map.find(topic);
+    if ((iter == m_map.end()) && (m_map.size() < MaxTracked)) {
+        iter = m_map.emplace(topic, Entry()).first;
+    }
+
+    if (iter != m_map.end()) {
+        auto& entry = iter->second;
+        ++entry.m_windowCount;
+        if (entry.m_aliased) {
+            ++entry.m_aliasedPublishes;
+
+            // The first publish after allocation still contains the topic
+            if (1U < entry.m_aliasedPublishes) {
+                m_bytesSaved += savingPerPublish(topic);
+            }
+        }
+    }
+
+    ++m_sinceEval;
+    return EvalPeriod <= m_sinceEval;
+}
+
+void Mqtt5ClientFilterTopicAliasTracker::evaluate(std::size_t limit, TopicsList& release, TopicsList& allocate)
+{
+    m_sinceEval = 0U;
+
+    using EntryPtr = Map::value_type*;
+    std::vector<EntryPtr> aliased;
+    std::vector<EntryPtr> candidates;
+
+    for (auto iter = m_map.begin(); iter != m_map.end();) {
+        auto& entry = iter->second;
+        auto saving = savingPerPublish(iter->first);
+        entry.m_score = (entry.m_score / 2U) + (entry.m_windowCount * saving);
+        entry.m_windowCount = 0U;
+
+        if (entry.m_aliased) {
+            aliased.push_back(&(*iter));
+            ++iter;
+            continue;
+        }
+
+        if (entry.m_score == 0U) {
+            iter = m_map.erase(iter);
+            continue;
+        }
+
+        // Require at least one publish per window on average
+        if ((2U * saving) <= entry.m_score) {
+            candidates.push_back(&(*iter));
+        }
+
+        ++iter;
+    }
+
+    auto releaseEntry = 
+        [this, &release](EntryPtr elem)
+        {
+            assert(elem->second.m_aliased);
+            elem->second.m_aliased = false;
+            elem->second.m_aliasedPublishes = 0U;
+            --m_aliasedCount;
+            release.push_back(elem->first);
+        };
+
+    auto allocateEntry = 
+        [this, &allocate](EntryPtr elem)
+        {
+            assert(!elem->second.m_aliased);
+            elem->second.m_aliased = true;
+            ++m_aliasedCount;
+            allocate.push_back(elem->first);
+        };
+
+    auto scoreLess = 
+        [](EntryPtr first, EntryPtr second)
+        {
+            return first->second.m_score < second->second.m_score;
+        };
+
+    // Weakest aliased first
+    std::sort(aliased.begin(), aliased.end(), scoreLess);
+    auto weakestIter = aliased.begin();
+    for (; weakestIter != aliased.end(); ++weakestIter) {
+        auto* elem = *weakestIter;
+        bool cold = elem->second.m_score < savingPerPublish(elem->first);
+        if ((!cold) && (m_aliasedCount <= limit)) {
+            break;
+        }
+
+        releaseEntry(elem);
+    }
+
+    // Strongest candidate first
+    std::sort(candidates.rbegin(), candidates.rend(), scoreLess);
+    for (auto* elem : candidates) {
+        if (m_aliasedCount < limit) {
+            allocateEntry(elem);
+            continue;
+        }
+
+        // Replace the existing alias only when significantly better
+        if ((weakestIter == aliased.end()) || 
+            (elem->second.m_score <= (2U * (*weakestIter)->second.m_score))) {
+            break;
+        }
+
+        releaseEntry(*weakestIter);
+        ++weakestIter;
+        allocateEntry(elem);
+    }
+}
+
+void Mqtt5ClientFilterTopicAliasTracker::allocFailed(const std::string& topic)
+{
+    auto iter = m_map.find(topic);
+    if ((iter == m_map.end()) || (!iter->second.m_aliased)) {
+        return;
+    }
+
+    iter->second.m_aliased = false;
+    iter->second.m_aliasedPublishes = 0U;
+    --m_aliasedCount;
+}
+
+Mqtt5ClientFilterTopicAliasTracker::TopicsList Mqtt5ClientFilterTopicAliasTracker::dropAliases()
+{
+    TopicsList result;
+    result.reserve(m_aliasedCount);
+    for (auto& elem : m_map) {
+        if (!elem.second.m_aliased) {
+            continue;
+        }
+
+        elem.second.m_aliased = false;
+        elem.second.m_aliasedPublishes = 0U;
+        result.push_back(elem.first);
+    }
+
+    m_aliasedCount = 0U;
+    return result;
+}
+
+void Mqtt5ClientFilterTopicAliasTracker::clear()
+{
+    m_map.clear();
+    m_aliasedCount = 0U;
+    m_sinceEval = 0U;
+    m_bytesSaved = 0U;
+}
+
+std::uint64_t Mqtt5ClientFilterTopicAliasTracker::savingPerPublish(const std::string& topic)
+{
+    if (topic.size() <= AliasOverhead) {
+        return 0U;
+    }
+
+    return topic.size() - AliasOverhead;
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
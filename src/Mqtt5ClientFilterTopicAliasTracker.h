@@ -0,0 +1,94 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Tracks the publish frequency of the outgoing topics and selects the ones
+// which save the most bytes on the wire when published using topic alias.
+// The publish counts are accumulated per evaluation window of EvalPeriod
+// publishes and exponentially decayed between the windows.
+class Mqtt5ClientFilterTopicAliasTracker
+{
+public:
+    static constexpr std::size_t EvalPeriod = 128U;
+    static constexpr std::size_t MaxTracked = 4096U;
+
+    // Topic alias property (1 + 2 bytes) replaces the topic
+    // string in the PUBLISH, the 2 bytes of the length remain.
+    static constexpr std::size_t AliasOverhead = 3U;
+
+    using TopicsList = std::vector<std::string>;
+
+    // Returns true when the evaluation is due.
+    bool record(const std::string& topic);
+
+    // Selects the topics to release and allocate the alias for, keeping the
+    // total number of the allocated aliases within the limit. The
+    // selected topics are assumed to be allocated, use allocFailed() to revert.
+    void evaluate(std::size_t limit, TopicsList& release, TopicsList& allocate);
+    void allocFailed(const std::string& topic);
+
+    // The aliases don't survive the network disconnection, returns
+    // the list of previously allocated ones.
+    TopicsList dropAliases();
+    void clear();
+
+    std::size_t aliasedCount() const
+    {
+        return m_aliasedCount;
+    }
+
+    std::uint64_t bytesSaved() const
+    {
+        return m_bytesSaved;
+    }
+
+    void resetStats()
+    {
+        m_bytesSaved = 0U;
+    }
+
+private:
+    struct Entry
+    {
+        std::uint64_t m_score = 0U;
+        std::uint64_t m_aliasedPublishes = 0U;
+        unsigned m_windowCount = 0U;
+        bool m_aliased = false;
+    };
+
+    using Map = std::unordered_map<std::string, Entry>;
+
+    static std::uint64_t savingPerPublish(const std::string& topic);
+
+    Map m_map;
+    std::size_t m_aliasedCount = 0U;
+    std::size_t m_sinceEval = 0U;
+    std::uint64_t m_bytesSaved = 0U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
+
@@ -0,0 +1,102 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterTopicAliasesModel.h"
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+Mqtt5ClientFilterTopicAliasesModel::Mqtt5ClientFilterTopicAliasesModel(Mqtt5ClientFilter& filter, QObject* parentObj) :
+    Base(filter.config().m_topicAliases, parentObj),
+    m_filter(filter)
+{
+}
+
+int Mqtt5ClientFilterTopicAliasesModel::columnCount(const QModelIndex& parentIdx) const
+{
+    if (parentIdx.isValid()) {
+        return 0;
+    }
+
+    return Column_ValuesLimit;
+}
+
+QVariant Mqtt5ClientFilterTopicAliasesModel::data(const QModelIndex& idx, int role) const
+{
+    auto* config = configAt(idx);
+    if ((config == nullptr) || (idx.column() != Column_Topic)) {
+        return QVariant();
+    }
+
+    if ((role != Qt::DisplayRole) && (role != Qt::EditRole)) {
+        return QVariant();
+    }
+
+    return config->m_topic;
+}
+
+bool Mqtt5ClientFilterTopicAliasesModel::setData(const QModelIndex& idx, const QVariant& value, int role)
+{
+    if ((idx.column() != Column_Topic) || (role != Qt::EditRole)) {
+        return false;
+    }
+
+    bool updated = updateConfigAt(
+        idx,
+        [&value](ConfigsList& configs, Mqtt5ClientFilter::TopicAliasConfig& config)
+        {
+            configs.setTopic(config, value.toString());
+            return true;
+        });
+
+    if (!updated) {
+        return false;
+    }
+
+    emit dataChanged(idx, idx);
+    return true;
+}
+
+Qt::ItemFlags Mqtt5ClientFilterTopicAliasesModel::flags(const QModelIndex& idx) const
+{
+    auto result = Base::flags(idx);
+    if (!idx.isValid()) {
+        return result;
+    }
+
+    return result | Qt::ItemIsEditable;
+}
+
+QVariant Mqtt5ClientFilterTopicAliasesModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if ((orientation == Qt::Horizontal) && (role == Qt::DisplayRole) && (section == Column_Topic)) {
+        return tr("Topic Alias");
+    }
+
+    return Base::headerData(section, orientation, role);
+}
+
+void Mqtt5ClientFilterTopicAliasesModel::updateConfigs(const UpdateFunc& func)
+{
+    m_filter.updateConfig(
+        [&func](Mqtt5ClientFilter::Config& config)
+        {
+            func(config.m_topicAliases);
+        });
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
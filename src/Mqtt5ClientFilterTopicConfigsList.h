@@ -0,0 +1,315 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QString>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// List of the topic configurations (subscribes, topic aliases) indexed by the topic.
+// The elements preserve insertion order and the references to them remain
+// valid until erased. The duplicate topics are allowed (can be created by the UI),
+// the lookup by topic returns the first of them in the list order.
+// The topic of the element must be updated using setTopic() to keep the index valid.
+// Every element is also assigned an id, unique for the lifetime of the list,
+// which can be held by the external code instead of the reference.
+// All the lookups (by topic, id or element) are constant time.
+template <typename TConfig>
+class Mqtt5ClientFilterTopicConfigsList
+{
+    using List = std::list<TConfig>;
+
+public:
+    using value_type = TConfig;
+    using iterator = typename List::iterator;
+    using const_iterator = typename List::const_iterator;
+    using Id = std::uint64_t;
+
+    static constexpr Id InvalidId = 0U;
+
+    Mqtt5ClientFilterTopicConfigsList() = default;
+
+    Mqtt5ClientFilterTopicConfigsList(const Mqtt5ClientFilterTopicConfigsList& other) :
+        m_list(other.m_list)
+    {
+        rebuildIndex();
+    }
+
+    // The moved list elements keep their addresses, so do the indexed iterators
+    Mqtt5ClientFilterTopicConfigsList(Mqtt5ClientFilterTopicConfigsList&& other) :
+        m_list(std::move(other.m_list)),
+        m_index(std::move(other.m_index)),
+        m_ids(std::move(other.m_ids)),
+        m_elemIds(std::move(other.m_elemIds)),
+        m_nextId(other.m_nextId)
+    {
+        other.clear();
+    }
+
+    Mqtt5ClientFilterTopicConfigsList& operator=(const Mqtt5ClientFilterTopicConfigsList& other)
+    {
+        if (&other != this) {
+            m_list = other.m_list;
+            rebuildIndex();
+        }
+
+        return *this;
+    }
+
+    Mqtt5ClientFilterTopicConfigsList& operator=(Mqtt5ClientFilterTopicConfigsList&& other)
+    {
+        if (&other != this) {
+            m_list = std::move(other.m_list);
+            m_index = std::move(other.m_index);
+            m_ids = std::move(other.m_ids);
+            m_elemIds = std::move(other.m_elemIds);
+            m_nextId = other.m_nextId;
+            other.clear();
+        }
+
+        return *this;
+    }
+
+    iterator begin()
+    {
+        return m_list.begin();
+    }
+
+    iterator end()
+    {
+        return m_list.end();
+    }
+
+    const_iterator begin() const
+    {
+        return m_list.begin();
+    }
+
+    const_iterator end() const
+    {
+        return m_list.end();
+    }
+
+    std::size_t size() const
+    {
+        return m_list.size();
+    }
+
+    bool empty() const
+    {
+        return m_list.empty();
+    }
+
+    TConfig& back()
+    {
+        assert(!m_list.empty());
+        return m_list.back();
+    }
+
+    void clear()
+    {
+        m_index.clear();
+        m_ids.clear();
+        m_elemIds.clear();
+        m_list.clear();
+    }
+
+    // Prepare the index for the bulk update
+    void reserve(std::size_t count)
+    {
+        m_index.reserve(static_cast<decltype(m_index.size())>(count));
+        m_ids.reserve(static_cast<decltype(m_ids.size())>(count));
+        m_elemIds.reserve(static_cast<decltype(m_elemIds.size())>(count));
+    }
+
+    // Appends new element even if its topic is already present
+    TConfig& append(TConfig config)
+    {
+        auto iter = m_list.insert(m_list.end(), std::move(config));
+        indexElem(iter);
+        return *iter;
+    }
+
+    Id idOf(const TConfig& config) const
+    {
+        return m_elemIds.value(&config, InvalidId);
+    }
+
+    // Ids of all the elements in the list order
+    std::vector<Id> ids() const
+    {
+        std::vector<Id> result;
+        result.reserve(m_list.size());
+        for (auto& config : m_list) {
+            result.push_back(idOf(config));
+        }
+        return result;
+    }
+
+    TConfig* findId(Id id)
+    {
+        auto iter = m_ids.find(id);
+        if (iter == m_ids.end()) {
+            return nullptr;
+        }
+
+        return &(*iter.value());
+    }
+
+    const TConfig* findId(Id id) const
+    {
+        auto iter = m_ids.find(id);
+        if (iter == m_ids.end()) {
+            return nullptr;
+        }
+
+        return &(*iter.value());
+    }
+
+    TConfig* find(const QString& topic)
+    {
+        return findId(firstId(topic));
+    }
+
+    const TConfig* find(const QString& topic) const
+    {
+        return findId(firstId(topic));
+    }
+
+    TConfig& findOrAppend(const QString& topic)
+    {
+        auto* config = find(topic);
+        if (config != nullptr) {
+            return *config;
+        }
+
+        TConfig newConfig;
+        newConfig.m_topic = topic;
+        return append(std::move(newConfig));
+    }
+
+    // Removes the first element with the topic
+    bool remove(const QString& topic)
+    {
+        return eraseId(firstId(topic));
+    }
+
+    bool remove(const TConfig& config)
+    {
+        return eraseId(idOf(config));
+    }
+
+    void setTopic(TConfig& config, const QString& topic)
+    {
+        auto id = idOf(config);
+        assert(id != InvalidId);
+        if (id == InvalidId) {
+            return;
+        }
+
+        unindexTopic(config.m_topic, id);
+        config.m_topic = topic;
+        m_index[topic].insert(id);
+    }
+
+private:
+    // The elements are only appended, so the ascending ids of the
+    // elements with the same topic also reflect the list order.
+    using TopicIds = std::set<Id>;
+    using Index = QHash<QString, TopicIds>;
+
+    Id firstId(const QString& topic) const
+    {
+        auto indexIter = m_index.find(topic);
+        if (indexIter == m_index.end()) {
+            return InvalidId;
+        }
+
+        assert(!indexIter.value().empty());
+        return *indexIter.value().begin();
+    }
+
+    void indexElem(iterator iter)
+    {
+        auto id = m_nextId;
+        ++m_nextId;
+        m_index[iter->m_topic].insert(id);
+        m_ids.insert(id, iter);
+        m_elemIds.insert(&(*iter), id);
+    }
+
+    void unindexTopic(const QString& topic, Id id)
+    {
+        auto indexIter = m_index.find(topic);
+        assert(indexIter != m_index.end());
+        if (indexIter == m_index.end()) {
+            return;
+        }
+
+        indexIter.value().erase(id);
+        if (indexIter.value().empty()) {
+            m_index.erase(indexIter);
+        }
+    }
+
+    bool eraseId(Id id)
+    {
+        auto idIter = m_ids.find(id);
+        if (idIter == m_ids.end()) {
+            return false;
+        }
+
+        auto iter = idIter.value();
+        m_ids.erase(idIter);
+        m_elemIds.remove(&(*iter));
+        unindexTopic(iter->m_topic, id);
+        m_list.erase(iter);
+        return true;
+    }
+
+    // The copied elements get new ids
+    void rebuildIndex()
+    {
+        m_index.clear();
+        m_ids.clear();
+        m_elemIds.clear();
+        reserve(m_list.size());
+        for (auto iter = m_list.begin(); iter != m_list.end(); ++iter) {
+            indexElem(iter);
+        }
+    }
+
+    List m_list;
+    Index m_index;
+    QHash<Id, iterator> m_ids;
+    QHash<const TConfig*, Id> m_elemIds;
+    Id m_nextId = InvalidId + 1U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,212 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Mqtt5ClientFilterTopicConfigsList.h"
+
+#include <QtCore/QAbstractTableModel>
+#include <QtCore/QModelIndex>
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Table model over the topic configurations list. The rows refer to the
+// list elements by their ids, the elements erased by the external update
+// are not accessed even before the update is applied incrementally by
+// sync() (used to avoid resetting the whole view). The list is read directly,
+// while its modifications are applied via updateConfigs() provided by the
+// derived class.
+template <typename TConfig>
+class Mqtt5ClientFilterTopicConfigsModel : public QAbstractTableModel
+{
+    using Base = QAbstractTableModel;
+
+public:
+    using ConfigsList = Mqtt5ClientFilterTopicConfigsList<TConfig>;
+    using ConfigId = typename ConfigsList::Id;
+
+    explicit Mqtt5ClientFilterTopicConfigsModel(const ConfigsList& configs, QObject* parentObj = nullptr) :
+        Base(parentObj),
+        m_configs(configs),
+        m_rows(configs.ids())
+    {
+    }
+
+    virtual int rowCount(const QModelIndex& parentIdx = QModelIndex()) const override
+    {
+        if (parentIdx.isValid()) {
+            return 0;
+        }
+
+        return static_cast<int>(m_rows.size());
+    }
+
+    virtual bool removeRows(int row, int count, const QModelIndex& parentIdx = QModelIndex()) override
+    {
+        if ((parentIdx.isValid()) || (row < 0) || (count <= 0) || (m_rows.size() < static_cast<std::size_t>(row + count))) {
+            return false;
+        }
+
+        beginRemoveRows(QModelIndex(), row, row + count - 1);
+        auto first = m_rows.begin() + row;
+        auto last = first + count;
+        updateConfigs(
+            [first, last](ConfigsList& configs)
+            {
+                for (auto iter = first; iter != last; ++iter) {
+                    auto* config = configs.findId(*iter);
+                    if (config != nullptr) {
+                        configs.remove(*config);
+                    }
+                }
+            });
+        m_rows.erase(first, last);
+        endRemoveRows();
+
+        configsUpdated();
+        return true;
+    }
+
+    // Appends new default configuration, returns the index of its first column
+    QModelIndex appendConfig()
+    {
+        auto row = static_cast<int>(m_rows.size());
+        auto id = ConfigsList::InvalidId;
+        beginInsertRows(QModelIndex(), row, row);
+        updateConfigs(
+            [&id](ConfigsList& configs)
+            {
+                id = configs.idOf(configs.append(TConfig()));
+            });
+        m_rows.push_back(id);
+        endInsertRows();
+        return index(row, 0);
+    }
+
+    // Applies the external update of the configurations list
+    void sync()
+    {
+        auto ids = m_configs.ids();
+        std::unordered_set<ConfigId> present(ids.begin(), ids.end());
+
+        // Remove the rows of the erased elements, contiguous ranges at once
+        auto row = static_cast<int>(m_rows.size());
+        while (row > 0) {
+            --row;
+            if (present.find(m_rows[static_cast<std::size_t>(row)]) != present.end()) {
+                continue;
+            }
+
+            auto last = row;
+            while ((row > 0) && (present.find(m_rows[static_cast<std::size_t>(row - 1)]) == present.end())) {
+                --row;
+            }
+
+            beginRemoveRows(QModelIndex(), row, last);
+            m_rows.erase(m_rows.begin() + row, m_rows.begin() + last + 1);
+            endRemoveRows();
+        }
+
+        // The new elements are expected to be appended, anything else requires reset
+        auto idIter = ids.begin();
+        for (auto id : m_rows) {
+            if ((idIter == ids.end()) || (*idIter != id)) {
+                reset();
+                return;
+            }
+
+            ++idIter;
+        }
+
+        if (!m_rows.empty()) {
+            // Only the visible rows are repainted
+            emit dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+        }
+
+        auto added = static_cast<int>(std::distance(idIter, ids.end()));
+        if (added == 0) {
+            return;
+        }
+
+        auto first = rowCount();
+        beginInsertRows(QModelIndex(), first, first + added - 1);
+        m_rows.insert(m_rows.end(), idIter, ids.end());
+        endInsertRows();
+    }
+
+protected:
+    using UpdateFunc = std::function<void (ConfigsList&)>;
+    using UpdateConfigFunc = std::function<bool (ConfigsList&, TConfig&)>;
+
+    const TConfig* configAt(const QModelIndex& idx) const
+    {
+        if ((!idx.isValid()) || (m_rows.size() <= static_cast<std::size_t>(idx.row()))) {
+            return nullptr;
+        }
+
+        return m_configs.findId(m_rows[static_cast<std::size_t>(idx.row())]);
+    }
+
+    // Applies the update to the configuration of the row, returns false 
+    // when the row doesn't exist or the update is rejected.
+    bool updateConfigAt(const QModelIndex& idx, const UpdateConfigFunc& func)
+    {
+        if ((!idx.isValid()) || (m_rows.size() <= static_cast<std::size_t>(idx.row()))) {
+            return false;
+        }
+
+        auto id = m_rows[static_cast<std::size_t>(idx.row())];
+        bool result = false;
+        updateConfigs(
+            [id, &func, &result](ConfigsList& configs)
+            {
+                auto* config = configs.findId(id);
+                if (config != nullptr) {
+                    result = func(configs, *config);
+                }
+            });
+
+        return result;
+    }
+
+    // Applies the modification of the configurations list
+    virtual void updateConfigs(const UpdateFunc& func) = 0;
+
+    // Invoked when the configuration is updated via the model
+    virtual void configsUpdated() {}
+
+private:
+    void reset()
+    {
+        beginResetModel();
+        m_rows = m_configs.ids();
+        endResetModel();
+    }
+
+    const ConfigsList& m_configs;
+    std::vector<ConfigId> m_rows;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,163 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterVirtualTimeSource.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+class Mqtt5ClientFilterVirtualTimeSource::VirtualTimer final : public Mqtt5ClientFilterTimer
+{
+public:
+    explicit VirtualTimer(Mqtt5ClientFilterVirtualTimeSource& source) :
+        m_source(source)
+    {
+        m_source.m_timers.push_back(this);
+    }
+
+    ~VirtualTimer() noexcept
+    {
+        auto& timers = m_source.m_timers;
+        timers.erase(std::remove(timers.begin(), timers.end(), this), timers.end());
+    }
+
+    TimePoint deadline() const
+    {
+        return m_deadline;
+    }
+
+    std::uint64_t startSeq() const
+    {
+        return m_startSeq;
+    }
+
+    void expire()
+    {
+        m_active = false;
+        reportTimeout();
+    }
+
+protected:
+    virtual void startImpl(std::chrono::milliseconds timeout) override
+    {
+        m_deadline = m_source.m_now + timeout;
+        m_startSeq = m_source.m_nextStartSeq;
+        ++m_source.m_nextStartSeq;
+        m_active = true;
+    }
+
+    virtual void stopImpl() override
+    {
+        m_active = false;
+    }
+
+    virtual bool isActiveImpl() const override
+    {
+        return m_active;
+    }
+
+private:
+    Mqtt5ClientFilterVirtualTimeSource& m_source;
+    TimePoint m_deadline;
+    std::uint64_t m_startSeq = 0U;
+    bool m_active = false;
+};
+
+Mqtt5ClientFilterVirtualTimeSource::Mqtt5ClientFilterVirtualTimeSource(TimePoint start) :
+    m_now(start)
+{
+}
+
+Mqtt5ClientFilterVirtualTimeSource::~Mqtt5ClientFilterVirtualTimeSource() noexcept
+{
+    assert(m_timers.empty());
+}
+
+void Mqtt5ClientFilterVirtualTimeSource::advance(std::chrono::milliseconds duration)
+{
+    auto end = m_now + duration;
+    while (true) {
+        auto* timer = nextTimer();
+        if ((timer == nullptr) || (end < timer->deadline())) {
+            break;
+        }
+
+        expire(*timer);
+    }
+
+    m_now = end;
+}
+
+bool Mqtt5ClientFilterVirtualTimeSource::advanceToTimeout()
+{
+    auto* timer = nextTimer();
+    if (timer == nullptr) {
+        return false;
+    }
+
+    expire(*timer);
+    return true;
+}
+
+std::chrono::milliseconds Mqtt5ClientFilterVirtualTimeSource::timeoutRemaining() const
+{
+    auto* timer = nextTimer();
+    if (timer == nullptr) {
+        return std::chrono::milliseconds(-1);
+    }
+
+    return std::chrono::duration_cast<std::chrono::milliseconds>(timer->deadline() - m_now);
+}
+
+Mqtt5ClientFilterVirtualTimeSource::TimePoint Mqtt5ClientFilterVirtualTimeSource::nowImpl() const
+{
+    return m_now;
+}
+
+Mqtt5ClientFilterTimerPtr Mqtt5ClientFilterVirtualTimeSource::createTimerImpl()
+{
+    return std::make_unique<VirtualTimer>(*this);
+}
+
+Mqtt5ClientFilterVirtualTimeSource::VirtualTimer* Mqtt5ClientFilterVirtualTimeSource::nextTimer() const
+{
+    VirtualTimer* result = nullptr;
+    for (auto* timer : m_timers) {
+        if (!timer->isActive()) {
+            continue;
+        }
+
+        if ((result == nullptr) || 
+            (timer->deadline() < result->deadline()) || 
+            ((timer->deadline() == result->deadline()) && (timer->startSeq() < result->startSeq()))) {
+            result = timer;
+        }
+    }
+
+    return result;
+}
+
+void Mqtt5ClientFilterVirtualTimeSource::expire(VirtualTimer& timer)
+{
+    m_now = std::max(m_now, timer.deadline());
+    timer.expire();
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
@@ -0,0 +1,64 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Mqtt5ClientFilterTimeSource.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Simulated time advanced explicitly by the driving code, allows running
+// long keep alive and timeout scenarios quickly and deterministically.
+class Mqtt5ClientFilterVirtualTimeSource final : public Mqtt5ClientFilterTimeSource
+{
+public:
+    // The default start differs from the default constructed time point
+    explicit Mqtt5ClientFilterVirtualTimeSource(TimePoint start = TimePoint(std::chrono::hours(1)));
+    ~Mqtt5ClientFilterVirtualTimeSource() noexcept;
+
+    // Advances the time, the timeouts expiring within the period
+    // (including the ones programmed by the timeout handlers) are reported
+    // in the order of their deadlines, the equal deadlines in the order of start.
+    void advance(std::chrono::milliseconds duration);
+
+    // Advances the time to the nearest programmed timeout and reports it,
+    // returns false when there is no programmed timeout.
+    bool advanceToTimeout();
+
+    // Time until the nearest programmed timeout, negative when there is none
+    std::chrono::milliseconds timeoutRemaining() const;
+
+protected:
+    virtual TimePoint nowImpl() const override;
+    virtual Mqtt5ClientFilterTimerPtr createTimerImpl() override;
+
+private:
+    class VirtualTimer;
+
+    VirtualTimer* nextTimer() const;
+    void expire(VirtualTimer& timer);
+
+    TimePoint m_now;
+    std::vector<VirtualTimer*> m_timers;
+    std::uint64_t m_nextStartSeq = 0U;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter
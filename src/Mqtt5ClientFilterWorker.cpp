@@ -0,0 +1,91 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "Mqtt5ClientFilterWorker.h"
+
+#include <QtCore/QMetaObject>
+
+#include <cassert>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+Mqtt5ClientFilterWorker::Mqtt5ClientFilterWorker() :
+    m_jobs(JobsCapacity)
+{
+    m_thread.setObjectName("mqtt5_client_filter");
+}
+
+Mqtt5ClientFilterWorker::~Mqtt5ClientFilterWorker() noexcept
+{
+    stop();
+}
+
+void Mqtt5ClientFilterWorker::start()
+{
+    if (m_thread.isRunning()) {
+        return;
+    }
+
+    m_ownerThread = QThread::currentThread();
+    moveToThread(&m_thread);
+    m_thread.start();
+}
+
+void Mqtt5ClientFilterWorker::stop()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    assert(!isWorkerThread());
+    auto* ownerThread = m_ownerThread;
+    exec(
+        [this, ownerThread]()
+        {
+            moveToThread(ownerThread);
+        });
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void Mqtt5ClientFilterWorker::exec(const Job& job)
+{
+    if ((!m_thread.isRunning()) || isWorkerThread()) {
+        job();
+        return;
+    }
+
+    // Only the owner thread submits jobs and it waits for the completion
+    // of each one, the queue cannot overflow.
+    [[maybe_unused]] bool pushed = m_jobs.push(&job);
+    assert(pushed);
+    QMetaObject::invokeMethod(this, &Mqtt5ClientFilterWorker::processJobs, Qt::QueuedConnection);
+    m_jobsDone.acquire();
+}
+
+void Mqtt5ClientFilterWorker::processJobs()
+{
+    const Job* job = nullptr;
+    while (m_jobs.pop(job)) {
+        (*job)();
+        m_jobsDone.release();
+    }
+}
+
+}  // namespace cc_plugin_mqtt5_client_filter
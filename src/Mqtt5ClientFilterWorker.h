@@ -0,0 +1,71 @@
+//
+// Copyright 2025 (C). Alex Robenko. All rights reserved.
+//
+
+// This file is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include "Mqtt5ClientFilterSpscQueue.h"
+
+#include <QtCore/QObject>
+#include <QtCore/QSemaphore>
+#include <QtCore/QThread>
+
+#include <functional>
+
+namespace cc_plugin_mqtt5_client_filter
+{
+
+// Executes jobs submitted by a single (GUI) thread on the dedicated worker thread.
+class Mqtt5ClientFilterWorker final : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Job = std::function<void()>;
+
+    Mqtt5ClientFilterWorker();
+    ~Mqtt5ClientFilterWorker() noexcept;
+
+    void start();
+    void stop();
+
+    QThread& workerThread()
+    {
+        return m_thread;
+    }
+
+    bool isWorkerThread() const
+    {
+        return QThread::currentThread() == &m_thread;
+    }
+
+    // Executes the job on the worker thread and waits for its completion,
+    // executed in place when invoked by the worker thread itself.
+    void exec(const Job& job);
+
+private slots:
+    void processJobs();
+
+private:
+    static constexpr std::size_t JobsCapacity = 16U;
+
+    QThread m_thread;
+    QThread* m_ownerThread = nullptr;
+    Mqtt5ClientFilterSpscQueue<const Job*> m_jobs;
+    QSemaphore m_jobsDone;
+};
+
+}  // namespace cc_plugin_mqtt5_client_filter